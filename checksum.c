@@ -34,6 +34,20 @@
 #include <impl/framework.h>
 
 
+/* SIMD checksum kernels are selected at run time from the CPU feature flags,
+ * the compile time selected routine remains the fallback.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || defined(__clang__))
+#	include <immintrin.h>
+#	define USE_CHECKSUM_SSE2
+#	define USE_CHECKSUM_AVX2
+#	if (defined(__GNUC__) && __GNUC__ >= 6) || defined(__clang__)
+#		define USE_CHECKSUM_AVX512
+#	endif
+#endif
+
+
 /* locals */
 
 static inline uint16_t do_csum (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
@@ -83,46 +97,6 @@ do_csum_8bit (
 	return htons ((uint16_t)acc);
 }
 
-/* Checksum and copy.  The theory being that cache locality benefits
- * calculation of the checksum whilst reading to copy.  The concern
- * however is that string operations may execute significantly faster
- * allowing a basic pipeline model to be preferred.
- *
- * Each CPU generation exhibits different characteristics, especially
- * with introduction of operators that can use wider data paths.
- */
-static
-uint16_t
-do_csumcpy_8bit (
-	const void* restrict srcaddr,
-	void*       restrict dstaddr,
-	uint16_t	     len,
-	uint32_t	     csum
-	)
-{
-	uint_fast32_t acc = csum;
-	const uint8_t*restrict src = (const uint8_t*restrict)srcaddr;
-	uint8_t*restrict dst = (uint8_t*restrict)dstaddr;
-
-	while (len >= sizeof (uint16_t)) {
-/* first byte as most significant */
-		uint_fast16_t word16 = (*dst++ = *src++) << 8;
-/* second byte as least significant */
-		word16 |= (*dst++ = *src++);
-		acc += word16;
-		len -= 2;
-	}
-/* trailing odd byte */
-	if (len > 0) {
-		const uint_fast16_t word16 = (*dst = *src) << 8;
-		acc += word16;
-	}
-/* fold accumulator down to 16-bits */
-	acc  = (acc >> 16) + (acc & 0xffff);
-	acc += (acc >> 16);
-	return htons ((uint16_t)acc);
-}
-
 /* When handling 16-bit words do not assume the pointer provided is aligned on
  * a word.  Aligned reads will also perform faster on platforms that support
  * unaligned word accesses.
@@ -185,6 +159,14 @@ do_csum_16bit (
 	return (uint16_t)acc;
 }
 
+/* Checksum and copy.  The theory being that cache locality benefits
+ * calculation of the checksum whilst reading to copy.  The concern
+ * however is that string operations may execute significantly faster
+ * allowing a basic pipeline model to be preferred.
+ *
+ * Each CPU generation exhibits different characteristics, especially
+ * with introduction of operators that can use wider data paths.
+ */
 static
 uint16_t
 do_csumcpy_16bit (
@@ -727,7 +709,7 @@ do_csumcpy_vector (
 							  "movq 5*8(%1), %%r13\n\t"
 							  "movq 6*8(%1), %%r14\n\t"
 							  "movq 7*8(%1), %%r15\n\t"
-							  "adcq %%r8, %0\n\t"		/* checksum */
+							  "addq %%r8, %0\n\t"		/* checksum */
 							  "adcq %%r9, %0\n\t"
 							  "adcq %%r10, %0\n\t"
 							  "adcq %%r11, %0\n\t"
@@ -754,13 +736,14 @@ do_csumcpy_vector (
 /* last 56 bytes */
 				while (count) {
 					uint64_t carry = 0;
+					*(uint64_t*restrict)dst = *(const uint64_t*restrict)src;
 					__asm__ volatile ("addq %1, %0\n\t"
 							  "adcq %2, %0"
 							: "=r" (acc)
 							: "m" (*(const uint64_t*restrict)src), "r" (carry), "0" (acc)
 							: "cc"  );
 					if (carry) acc++;
-					count--; src += 8;
+					count--; src += 8; dst += 8;
 				}
 				acc  = (acc >> 32) + (acc & 0xffffffff);
 			}
@@ -793,6 +776,278 @@ do_csumcpy_vector (
 
 #endif
 
+/* SIMD kernels sum the 16-bit words of each 32-bit lane into 32-bit lane
+ * accumulators with unaligned loads, words remain paired from the start of
+ * the buffer so the data needs no odd address byte swap.  A 64KB TPDU sums to
+ * less than 2³¹ so neither the lanes nor their total can overflow.  The tail
+ * shorter than one vector is handed to the 64-bit routine, it starts at an
+ * even offset so its sum adds directly.
+ */
+
+#define CSUM_FOLD64(acc) \
+	do { \
+		(acc)  = ((acc) >> 32) + ((acc) & 0xffffffff); \
+		(acc)  = ((acc) >> 16) + ((acc) & 0xffff); \
+		(acc)  = ((acc) >> 16) + ((acc) & 0xffff); \
+		(acc) += ((acc) >> 16); \
+	} while (0)
+
+/* The scalar routines add the caller csum before the odd address byte swap
+ * of the total, so for an odd address the csum is swapped into the result.
+ * Start the accumulator the same way.
+ */
+
+static inline
+uint64_t
+_pgm_csum_seed (
+	const void*	addr,
+	uint32_t	csum
+	)
+{
+	if (PGM_LIKELY(!((uintptr_t)addr & 1)))
+		return csum;
+	csum  = (csum >> 16) + (csum & 0xffff);
+	csum += (csum >> 16);
+	return ((csum & 0xff) << 8) | ((csum & 0xff00) >> 8);
+}
+
+#ifdef USE_CHECKSUM_SSE2
+__attribute__((target("sse2")))
+static
+uint64_t
+_pgm_csum_sum128 (
+	const __m128i	sum
+	)
+{
+	uint32_t lanes[4];
+	_mm_storeu_si128 ((__m128i*)lanes, sum);
+	return (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("sse2")))
+static
+uint16_t
+do_csum_sse2 (
+	const void*	addr,
+	uint16_t	len,
+	uint32_t	csum
+	)
+{
+	const uint8_t* buf = (const uint8_t*)addr;
+	uint64_t acc;
+
+/* empty buffer */
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)csum;
+	acc = _pgm_csum_seed (addr, csum);
+	if (len >= 16) {
+		const __m128i mask = _mm_set1_epi32 (0xffff);
+		__m128i sum = _mm_setzero_si128();
+		do {
+			const __m128i x = _mm_loadu_si128 ((const __m128i*)buf);
+			sum = _mm_add_epi32 (sum, _mm_and_si128 (x, mask));
+			sum = _mm_add_epi32 (sum, _mm_srli_epi32 (x, 16));
+			buf += 16; len -= 16;
+		} while (len >= 16);
+		acc += _pgm_csum_sum128 (sum);
+	}
+	acc += do_csum_64bit (buf, len, 0);
+	CSUM_FOLD64 (acc);
+	return (uint16_t)acc;
+}
+
+__attribute__((target("sse2")))
+static
+uint16_t
+do_csumcpy_sse2 (
+	const void* restrict srcaddr,
+	void*	    restrict dstaddr,
+	uint16_t	     len,
+	uint32_t	     csum
+	)
+{
+	const uint8_t*restrict src = (const uint8_t*restrict)srcaddr;
+	uint8_t*restrict dst = (uint8_t*restrict)dstaddr;
+	uint64_t acc;
+
+/* empty buffer */
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)csum;
+	acc = _pgm_csum_seed (srcaddr, csum);
+	if (len >= 16) {
+		const __m128i mask = _mm_set1_epi32 (0xffff);
+		__m128i sum = _mm_setzero_si128();
+		do {
+			const __m128i x = _mm_loadu_si128 ((const __m128i*)src);
+			_mm_storeu_si128 ((__m128i*)dst, x);
+			sum = _mm_add_epi32 (sum, _mm_and_si128 (x, mask));
+			sum = _mm_add_epi32 (sum, _mm_srli_epi32 (x, 16));
+			src += 16; dst += 16; len -= 16;
+		} while (len >= 16);
+		acc += _pgm_csum_sum128 (sum);
+	}
+	acc += do_csumcpy_64bit (src, dst, len, 0);
+	CSUM_FOLD64 (acc);
+	return (uint16_t)acc;
+}
+#endif /* USE_CHECKSUM_SSE2 */
+
+#ifdef USE_CHECKSUM_AVX2
+__attribute__((target("avx2")))
+static
+uint16_t
+do_csum_avx2 (
+	const void*	addr,
+	uint16_t	len,
+	uint32_t	csum
+	)
+{
+	const uint8_t* buf = (const uint8_t*)addr;
+	uint64_t acc;
+
+/* empty buffer */
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)csum;
+	acc = _pgm_csum_seed (addr, csum);
+	if (len >= 32) {
+		const __m256i mask = _mm256_set1_epi32 (0xffff);
+		__m256i sum = _mm256_setzero_si256();
+		do {
+			const __m256i x = _mm256_loadu_si256 ((const __m256i*)buf);
+			sum = _mm256_add_epi32 (sum, _mm256_and_si256 (x, mask));
+			sum = _mm256_add_epi32 (sum, _mm256_srli_epi32 (x, 16));
+			buf += 32; len -= 32;
+		} while (len >= 32);
+		acc += _pgm_csum_sum128 (_mm_add_epi32 (_mm256_castsi256_si128 (sum),
+							_mm256_extracti128_si256 (sum, 1)));
+	}
+	acc += do_csum_64bit (buf, len, 0);
+	CSUM_FOLD64 (acc);
+	return (uint16_t)acc;
+}
+
+__attribute__((target("avx2")))
+static
+uint16_t
+do_csumcpy_avx2 (
+	const void* restrict srcaddr,
+	void*	    restrict dstaddr,
+	uint16_t	     len,
+	uint32_t	     csum
+	)
+{
+	const uint8_t*restrict src = (const uint8_t*restrict)srcaddr;
+	uint8_t*restrict dst = (uint8_t*restrict)dstaddr;
+	uint64_t acc;
+
+/* empty buffer */
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)csum;
+	acc = _pgm_csum_seed (srcaddr, csum);
+	if (len >= 32) {
+		const __m256i mask = _mm256_set1_epi32 (0xffff);
+		__m256i sum = _mm256_setzero_si256();
+		do {
+			const __m256i x = _mm256_loadu_si256 ((const __m256i*)src);
+			_mm256_storeu_si256 ((__m256i*)dst, x);
+			sum = _mm256_add_epi32 (sum, _mm256_and_si256 (x, mask));
+			sum = _mm256_add_epi32 (sum, _mm256_srli_epi32 (x, 16));
+			src += 32; dst += 32; len -= 32;
+		} while (len >= 32);
+		acc += _pgm_csum_sum128 (_mm_add_epi32 (_mm256_castsi256_si128 (sum),
+							_mm256_extracti128_si256 (sum, 1)));
+	}
+	acc += do_csumcpy_64bit (src, dst, len, 0);
+	CSUM_FOLD64 (acc);
+	return (uint16_t)acc;
+}
+#endif /* USE_CHECKSUM_AVX2 */
+
+#ifdef USE_CHECKSUM_AVX512
+__attribute__((target("avx512f")))
+static
+uint64_t
+_pgm_csum_sum512 (
+	const __m512i	sum
+	)
+{
+	uint32_t lanes[16];
+	uint64_t acc = 0;
+	unsigned i;
+	_mm512_storeu_si512 ((void*)lanes, sum);
+	for (i = 0; i < 16; i++)
+		acc += lanes[i];
+	return acc;
+}
+
+__attribute__((target("avx512f")))
+static
+uint16_t
+do_csum_avx512 (
+	const void*	addr,
+	uint16_t	len,
+	uint32_t	csum
+	)
+{
+	const uint8_t* buf = (const uint8_t*)addr;
+	uint64_t acc;
+
+/* empty buffer */
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)csum;
+	acc = _pgm_csum_seed (addr, csum);
+	if (len >= 64) {
+		const __m512i mask = _mm512_set1_epi32 (0xffff);
+		__m512i sum = _mm512_setzero_si512();
+		do {
+			const __m512i x = _mm512_loadu_si512 ((const void*)buf);
+			sum = _mm512_add_epi32 (sum, _mm512_and_si512 (x, mask));
+			sum = _mm512_add_epi32 (sum, _mm512_srli_epi32 (x, 16));
+			buf += 64; len -= 64;
+		} while (len >= 64);
+		acc += _pgm_csum_sum512 (sum);
+	}
+	acc += do_csum_64bit (buf, len, 0);
+	CSUM_FOLD64 (acc);
+	return (uint16_t)acc;
+}
+
+__attribute__((target("avx512f")))
+static
+uint16_t
+do_csumcpy_avx512 (
+	const void* restrict srcaddr,
+	void*	    restrict dstaddr,
+	uint16_t	     len,
+	uint32_t	     csum
+	)
+{
+	const uint8_t*restrict src = (const uint8_t*restrict)srcaddr;
+	uint8_t*restrict dst = (uint8_t*restrict)dstaddr;
+	uint64_t acc;
+
+/* empty buffer */
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)csum;
+	acc = _pgm_csum_seed (srcaddr, csum);
+	if (len >= 64) {
+		const __m512i mask = _mm512_set1_epi32 (0xffff);
+		__m512i sum = _mm512_setzero_si512();
+		do {
+			const __m512i x = _mm512_loadu_si512 ((const void*)src);
+			_mm512_storeu_si512 ((void*)dst, x);
+			sum = _mm512_add_epi32 (sum, _mm512_and_si512 (x, mask));
+			sum = _mm512_add_epi32 (sum, _mm512_srli_epi32 (x, 16));
+			src += 64; dst += 64; len -= 64;
+		} while (len >= 64);
+		acc += _pgm_csum_sum512 (sum);
+	}
+	acc += do_csumcpy_64bit (src, dst, len, 0);
+	CSUM_FOLD64 (acc);
+	return (uint16_t)acc;
+}
+#endif /* USE_CHECKSUM_AVX512 */
+
 static inline
 uint16_t
 do_csum (
@@ -816,6 +1071,70 @@ do_csum (
 #endif
 }
 
+static inline
+uint16_t
+do_csumcpy (
+	const void* restrict src,
+	void*	    restrict dst,
+	uint16_t	     len,
+	uint32_t	     csum
+	)
+{
+#if defined( __sparc__ ) || defined( __sparc ) || defined( __sparcv9 ) || defined( USE_8BIT_CHECKSUM )
+/* SPARC will not handle destination & source addresses with different alignment,
+ * the endian independent routine gains nothing from a fused copy.
+ */
+	memcpy (dst, src, len);
+	return do_csum (dst, len, csum);
+#elif defined( USE_16BIT_CHECKSUM )
+	return do_csumcpy_16bit (src, dst, len, csum);
+#elif defined( USE_32BIT_CHECKSUM )
+	return do_csumcpy_32bit (src, dst, len, csum);
+#elif defined( USE_64BIT_CHECKSUM )
+	return do_csumcpy_64bit (src, dst, len, csum);
+#elif defined( USE_VECTOR_CHECKSUM )
+	return do_csumcpy_vector (src, dst, len, csum);
+#else
+#	error "checksum routine undefined"
+#endif
+}
+
+typedef uint16_t (*pgm_csum_func)(const void*, uint16_t, uint32_t);
+typedef uint16_t (*pgm_csumcpy_func)(const void*restrict, void*restrict, uint16_t, uint32_t);
+
+static pgm_csum_func _pgm_csum PGM_GNUC_READ_MOSTLY = do_csum;
+static pgm_csumcpy_func _pgm_csumcpy PGM_GNUC_READ_MOSTLY = do_csumcpy;
+
+/* select the widest checksum kernels supported by this processor, called
+ * once from pgm_init().
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_checksum_init (void)
+{
+#ifdef USE_CHECKSUM_SSE2
+	__builtin_cpu_init ();
+#	ifdef USE_CHECKSUM_AVX512
+	if (__builtin_cpu_supports ("avx512f")) {
+		_pgm_csum    = do_csum_avx512;
+		_pgm_csumcpy = do_csumcpy_avx512;
+		return;
+	}
+#	endif
+	if (__builtin_cpu_supports ("avx2")) {
+		_pgm_csum    = do_csum_avx2;
+		_pgm_csumcpy = do_csumcpy_avx2;
+		return;
+	}
+	if (__builtin_cpu_supports ("sse2")) {
+		_pgm_csum    = do_csum_sse2;
+		_pgm_csumcpy = do_csumcpy_sse2;
+		return;
+	}
+#endif
+}
+
 /* Calculate an IP header style checksum
  */
 
@@ -830,7 +1149,7 @@ pgm_inet_checksum (
 	pgm_assert (NULL != addr);
 
 /* invert to get the ones-complement. */
-	return ~do_csum (addr, len, csum);
+	return ~_pgm_csum (addr, len, csum);
 }
 
 /* Calculate a partial (unfolded) checksum
@@ -847,7 +1166,7 @@ pgm_compat_csum_partial (
 	pgm_assert (NULL != addr);
 
 	csum  = (csum >> 16) + (csum & 0xffff);
-	csum += do_csum (addr, len, 0);
+	csum += _pgm_csum (addr, len, 0);
 	csum  = (csum >> 16) + (csum & 0xffff);
 
 	return csum;
@@ -870,26 +1189,7 @@ pgm_compat_csum_partial_copy (
 	pgm_assert (NULL != src);
 	pgm_assert (NULL != dst);
 
-#if defined( __sparc__ ) || defined( __sparc ) || defined( __sparcv9 )
-/* SPARC will not handle destination & source addresses with different alignment */
-	memcpy (dst, src, len);
-	return pgm_csum_partial (dst, len, csum);
-#else
-#	if   defined( USE_8BIT_CHECKSUM )
-	return do_csumcpy_8bit (src, dst, len, csum);
-#	elif defined( USE_16BIT_CHECKSUM )
-	return do_csumcpy_16bit (src, dst, len, csum);
-#	elif defined( USE_32BIT_CHECKSUM )
-	return do_csumcpy_32bit (src, dst, len, csum);
-#	elif defined( USE_64BIT_CHECKSUM )
-	return do_csumcpy_64bit (src, dst, len, csum);
-#	elif defined( USE_VECTOR_CHECKSUM )
-	return do_csumcpy_vector (src, dst, len, csum);
-#	else
-	memcpy (dst, src, len);
-	return pgm_csum_partial (dst, len, csum);
-#	endif
-#endif
+	return _pgm_csumcpy (src, dst, len, csum);
 }
 
 /* Fold 32 bit checksum accumulator into 16 bit final value.
@@ -179,37 +179,6 @@ START_TEST (test_8bit_memcpy)
 }
 END_TEST
 
-/* checksum & copy */
-START_TEST (test_8bit_csumcpy)
-{
-	const unsigned iterations = 1000;
-	char* source = alloca (perf_testsize);
-	char* target = alloca (perf_testsize);
-	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
-		j = j * 1103515245 + 12345;
-		source[i] = j;
-	}
-	const guint16 answer = perf_answer;		/* network order */
-
-	guint16 csum;
-	pgm_time_t start, check;
-
-	start = pgm_time_update_now();
-	for (unsigned i = iterations; i; i--) {
-		csum = ~do_csumcpy_8bit (source, target, perf_testsize, 0);
-/* function calculates answer in host order */
-		csum = g_htons (csum);
-		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
-	}
-
-	check = pgm_time_update_now();
-	g_message ("8-bit/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
-		perf_testsize,
-		(guint64)(check - start),
-		(guint64)((check - start) / iterations));
-}
-END_TEST
-
 START_TEST (test_16bit)
 {
 	const unsigned iterations = 1000;
@@ -572,6 +541,269 @@ START_TEST (test_vector_csumcpy)
 END_TEST
 #endif /* defined(__amd64) || defined(__x86_64__) || defined(_WIN64) */
 
+/* run time selected SIMD kernels, the copy variants also verify the
+ * destination buffer.
+ */
+
+#ifdef USE_CHECKSUM_SSE2
+static
+void
+perf_csum (
+	const char*		name,
+	pgm_csum_func		func
+	)
+{
+	const unsigned iterations = 1000;
+	char* source = alloca (perf_testsize);
+	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint16 answer = perf_answer;		/* network order */
+
+	guint16 csum;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		csum = ~func (source, perf_testsize, 0);
+/* function calculates answer in host order */
+		csum = g_htons (csum);
+		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
+	}
+
+	check = pgm_time_update_now();
+	g_message ("%s/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
+		name, perf_testsize,
+		(guint64)(check - start),
+		(guint64)((check - start) / iterations));
+}
+
+static
+void
+perf_memcpy (
+	const char*		name,
+	pgm_csum_func		func
+	)
+{
+	const unsigned iterations = 1000;
+	char* source = alloca (perf_testsize);
+	char* target = alloca (perf_testsize);
+	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint16 answer = perf_answer;		/* network order */
+
+	guint16 csum;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		memcpy (target, source, perf_testsize);
+		csum = ~func (target, perf_testsize, 0);
+/* function calculates answer in host order */
+		csum = g_htons (csum);
+		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
+	}
+
+	check = pgm_time_update_now();
+	g_message ("%s/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
+		name, perf_testsize,
+		(guint64)(check - start),
+		(guint64)((check - start) / iterations));
+}
+
+static
+void
+perf_csumcpy (
+	const char*		name,
+	pgm_csumcpy_func	func
+	)
+{
+	const unsigned iterations = 1000;
+	char* source = alloca (perf_testsize);
+	char* target = alloca (perf_testsize);
+	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint16 answer = perf_answer;		/* network order */
+
+	guint16 csum;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		csum = ~func (source, target, perf_testsize, 0);
+/* function calculates answer in host order */
+		csum = g_htons (csum);
+		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
+	}
+
+	check = pgm_time_update_now();
+	fail_unless (0 == memcmp (source, target, perf_testsize), "copy mismatch");
+	g_message ("%s/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
+		name, perf_testsize,
+		(guint64)(check - start),
+		(guint64)((check - start) / iterations));
+}
+
+START_TEST (test_sse2)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("sse2")) {
+		g_message ("sse2: not supported by processor");
+		return;
+	}
+	perf_csum ("sse2", do_csum_sse2);
+}
+END_TEST
+
+START_TEST (test_sse2_memcpy)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("sse2")) {
+		g_message ("sse2: not supported by processor");
+		return;
+	}
+	perf_memcpy ("sse2", do_csum_sse2);
+}
+END_TEST
+
+START_TEST (test_sse2_csumcpy)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("sse2")) {
+		g_message ("sse2: not supported by processor");
+		return;
+	}
+	perf_csumcpy ("sse2", do_csumcpy_sse2);
+}
+END_TEST
+#endif /* USE_CHECKSUM_SSE2 */
+
+#ifdef USE_CHECKSUM_AVX2
+START_TEST (test_avx2)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx2")) {
+		g_message ("avx2: not supported by processor");
+		return;
+	}
+	perf_csum ("avx2", do_csum_avx2);
+}
+END_TEST
+
+START_TEST (test_avx2_memcpy)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx2")) {
+		g_message ("avx2: not supported by processor");
+		return;
+	}
+	perf_memcpy ("avx2", do_csum_avx2);
+}
+END_TEST
+
+START_TEST (test_avx2_csumcpy)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx2")) {
+		g_message ("avx2: not supported by processor");
+		return;
+	}
+	perf_csumcpy ("avx2", do_csumcpy_avx2);
+}
+END_TEST
+#endif /* USE_CHECKSUM_AVX2 */
+
+#ifdef USE_CHECKSUM_AVX512
+START_TEST (test_avx512)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx512f")) {
+		g_message ("avx512: not supported by processor");
+		return;
+	}
+	perf_csum ("avx512", do_csum_avx512);
+}
+END_TEST
+
+START_TEST (test_avx512_memcpy)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx512f")) {
+		g_message ("avx512: not supported by processor");
+		return;
+	}
+	perf_memcpy ("avx512", do_csum_avx512);
+}
+END_TEST
+
+START_TEST (test_avx512_csumcpy)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx512f")) {
+		g_message ("avx512: not supported by processor");
+		return;
+	}
+	perf_csumcpy ("avx512", do_csumcpy_avx512);
+}
+END_TEST
+#endif /* USE_CHECKSUM_AVX512 */
+
+static
+void
+add_simd_tests (
+	TCase*		tc
+	)
+{
+#ifdef USE_CHECKSUM_SSE2
+	tcase_add_test (tc, test_sse2);
+#endif
+#ifdef USE_CHECKSUM_AVX2
+	tcase_add_test (tc, test_avx2);
+#endif
+#ifdef USE_CHECKSUM_AVX512
+	tcase_add_test (tc, test_avx512);
+#endif
+}
+
+static
+void
+add_simd_memcpy_tests (
+	TCase*		tc
+	)
+{
+#ifdef USE_CHECKSUM_SSE2
+	tcase_add_test (tc, test_sse2_memcpy);
+#endif
+#ifdef USE_CHECKSUM_AVX2
+	tcase_add_test (tc, test_avx2_memcpy);
+#endif
+#ifdef USE_CHECKSUM_AVX512
+	tcase_add_test (tc, test_avx512_memcpy);
+#endif
+}
+
+static
+void
+add_simd_csumcpy_tests (
+	TCase*		tc
+	)
+{
+#ifdef USE_CHECKSUM_SSE2
+	tcase_add_test (tc, test_sse2_csumcpy);
+#endif
+#ifdef USE_CHECKSUM_AVX2
+	tcase_add_test (tc, test_avx2_csumcpy);
+#endif
+#ifdef USE_CHECKSUM_AVX512
+	tcase_add_test (tc, test_avx512_csumcpy);
+#endif
+}
+
 
 
 static
@@ -593,6 +825,7 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_100b, test_vector);
 #endif
+	add_simd_tests (tc_100b);
 
 	TCase* tc_200b = tcase_create ("200b");
 	suite_add_tcase (s, tc_200b);
@@ -605,6 +838,7 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_200b, test_vector);
 #endif
+	add_simd_tests (tc_200b);
 
 	TCase* tc_1500b = tcase_create ("1500b");
 	suite_add_tcase (s, tc_1500b);
@@ -617,6 +851,7 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_1500b, test_vector);
 #endif
+	add_simd_tests (tc_1500b);
 
 	TCase* tc_9kb = tcase_create ("9KB");
 	suite_add_tcase (s, tc_9kb);
@@ -629,6 +864,7 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_9kb, test_vector);
 #endif
+	add_simd_tests (tc_9kb);
 
 	TCase* tc_64kb = tcase_create ("64KB");
 	suite_add_tcase (s, tc_64kb);
@@ -641,6 +877,7 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_64kb, test_vector);
 #endif
+	add_simd_tests (tc_64kb);
 
 	return s;
 }
@@ -664,6 +901,7 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_100b, test_vector_memcpy);
 #endif
+	add_simd_memcpy_tests (tc_100b);
 
 	TCase* tc_200b = tcase_create ("200b");
 	suite_add_tcase (s, tc_200b);
@@ -676,6 +914,7 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_200b, test_vector_memcpy);
 #endif
+	add_simd_memcpy_tests (tc_200b);
 
 	TCase* tc_1500b = tcase_create ("1500b");
 	suite_add_tcase (s, tc_1500b);
@@ -688,6 +927,7 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_1500b, test_vector_memcpy);
 #endif
+	add_simd_memcpy_tests (tc_1500b);
 
 	TCase* tc_9kb = tcase_create ("9KB");
 	suite_add_tcase (s, tc_9kb);
@@ -700,6 +940,7 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_9kb, test_vector_memcpy);
 #endif
+	add_simd_memcpy_tests (tc_9kb);
 
 	TCase* tc_64kb = tcase_create ("64KB");
 	suite_add_tcase (s, tc_64kb);
@@ -712,6 +953,7 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_64kb, test_vector_memcpy);
 #endif
+	add_simd_memcpy_tests (tc_64kb);
 
 	return s;
 }
@@ -728,61 +970,61 @@ make_csumcpy_performance_suite (void)
 	suite_add_tcase (s, tc_100b);
 	tcase_add_checked_fixture (tc_100b, mock_setup, mock_teardown);
 	tcase_add_checked_fixture (tc_100b, mock_setup_100b, NULL);
-	tcase_add_test (tc_100b, test_8bit_csumcpy);
 	tcase_add_test (tc_100b, test_16bit_csumcpy);
 	tcase_add_test (tc_100b, test_32bit_csumcpy);
 	tcase_add_test (tc_100b, test_64bit_csumcpy);
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_100b, test_vector_csumcpy);
 #endif
+	add_simd_csumcpy_tests (tc_100b);
 
 	TCase* tc_200b = tcase_create ("200b");
 	suite_add_tcase (s, tc_200b);
 	tcase_add_checked_fixture (tc_200b, mock_setup, mock_teardown);
 	tcase_add_checked_fixture (tc_200b, mock_setup_200b, NULL);
-	tcase_add_test (tc_200b, test_8bit_csumcpy);
 	tcase_add_test (tc_200b, test_16bit_csumcpy);
 	tcase_add_test (tc_200b, test_32bit_csumcpy);
 	tcase_add_test (tc_200b, test_64bit_csumcpy);
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_200b, test_vector_csumcpy);
 #endif
+	add_simd_csumcpy_tests (tc_200b);
 
 	TCase* tc_1500b = tcase_create ("1500b");
 	suite_add_tcase (s, tc_1500b);
 	tcase_add_checked_fixture (tc_1500b, mock_setup, mock_teardown);
 	tcase_add_checked_fixture (tc_1500b, mock_setup_1500b, NULL);
-	tcase_add_test (tc_1500b, test_8bit_csumcpy);
 	tcase_add_test (tc_1500b, test_16bit_csumcpy);
 	tcase_add_test (tc_1500b, test_32bit_csumcpy);
 	tcase_add_test (tc_1500b, test_64bit_csumcpy);
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_1500b, test_vector_csumcpy);
 #endif
+	add_simd_csumcpy_tests (tc_1500b);
 
 	TCase* tc_9kb = tcase_create ("9KB");
 	suite_add_tcase (s, tc_9kb);
 	tcase_add_checked_fixture (tc_9kb, mock_setup, mock_teardown);
 	tcase_add_checked_fixture (tc_9kb, mock_setup_9kb, NULL);
-	tcase_add_test (tc_9kb, test_8bit_csumcpy);
 	tcase_add_test (tc_9kb, test_16bit_csumcpy);
 	tcase_add_test (tc_9kb, test_32bit_csumcpy);
 	tcase_add_test (tc_9kb, test_64bit_csumcpy);
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_9kb, test_vector_csumcpy);
 #endif
+	add_simd_csumcpy_tests (tc_9kb);
 
 	TCase* tc_64kb = tcase_create ("64KB");
 	suite_add_tcase (s, tc_64kb);
 	tcase_add_checked_fixture (tc_64kb, mock_setup, mock_teardown);
 	tcase_add_checked_fixture (tc_64kb, mock_setup_64kb, NULL);
-	tcase_add_test (tc_64kb, test_8bit_csumcpy);
 	tcase_add_test (tc_64kb, test_16bit_csumcpy);
 	tcase_add_test (tc_64kb, test_32bit_csumcpy);
 	tcase_add_test (tc_64kb, test_64bit_csumcpy);
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_64kb, test_vector_csumcpy);
 #endif
+	add_simd_csumcpy_tests (tc_64kb);
 
 	return s;
 }
@@ -217,6 +217,44 @@ START_TEST (test_partial_copy_pass_001)
 }
 END_TEST
 
+/* run time selected kernel against the 16-bit routine at every alignment and
+ * vector tail length, with and without a caller csum, destination must match
+ * source.
+ */
+
+START_TEST (test_partial_copy_pass_002)
+{
+	const unsigned max_len = 9000 + 3;
+	char* source = g_malloc (max_len);
+	char* dest   = g_malloc (max_len);
+	for (unsigned i = 0, j = 0; i < max_len; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint32 seeds[] = { 0, 0x12c4, 0x3f0a81 };
+	pgm_checksum_init ();
+	for (unsigned seed = 0; seed < G_N_ELEMENTS(seeds); seed++)
+	{
+		for (unsigned offset = 0; offset < 4; offset++)
+		{
+			for (unsigned len = 0; len <= 9000; len = len < 200 ? len + 1 : len + 883)
+			{
+				const guint16 answer = do_csum_16bit (source + offset, len, seeds[seed]);
+				memset (dest, 0, max_len);
+				const guint32 csum = pgm_csum_partial_copy (source + offset, dest + offset, len, seeds[seed]);
+				fail_unless (answer == csum, "checksum mismatch seed 0x%x offset %u len %u", seeds[seed], offset, len);
+				fail_unless (0 == memcmp (source + offset, dest + offset, len), "copy mismatch offset %u len %u", offset, len);
+				if (seeds[seed] > 0xffff)
+					continue;
+				fail_unless (answer == (guint16)~pgm_inet_checksum (source + offset, len, (guint16)seeds[seed]), "inet checksum mismatch seed 0x%x offset %u len %u", seeds[seed], offset, len);
+			}
+		}
+	}
+	g_free (dest);
+	g_free (source);
+}
+END_TEST
+
 START_TEST (test_partial_copy_fail_001)
 {
 	pgm_csum_partial_copy (NULL, NULL, 0, 0);
@@ -288,6 +326,7 @@ make_test_suite (void)
 	TCase* tc_partial_copy = tcase_create ("partial-copy");
 	suite_add_tcase (s, tc_partial_copy);
 	tcase_add_test (tc_partial_copy, test_partial_copy_pass_001);
+	tcase_add_test (tc_partial_copy, test_partial_copy_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_partial_copy, test_partial_copy_fail_001, SIGABRT);
 #endif
@@ -99,6 +99,8 @@ pgm_init (
 	pgm_thread_init();
 	pgm_mem_init();
 	pgm_rand_init();
+	pgm_checksum_init();
+	pgm_rs_init();
 
 #ifdef _WIN32
 	WORD wVersionRequested = MAKEWORD (2, 2);
@@ -27,42 +27,89 @@
 
 //#define HASHTABLE_DEBUG
 
-#define HASHTABLE_MIN_SIZE	11
-#define HASHTABLE_MAX_SIZE	13845163
+/* open addressing with linear probing and Robin Hood displacement, nodes
+ * hold the key hash inline so that a lookup compares keys only on a full
+ * hash match and usually touches one cache line of the node array.
+ */
+
+#define HASHTABLE_MIN_SIZE	16
+#define HASHTABLE_MAX_SIZE	(1U << 30)
 
 struct pgm_hashnode_t
 {
-	const void*		key;
+	const void*		key;		/* NULL = empty */
 	void*			value;
-	struct pgm_hashnode_t*	next;
-	uint_fast32_t		key_hash;
+	uint32_t		key_hash;
 };
 
 typedef struct pgm_hashnode_t pgm_hashnode_t;
 
 struct pgm_hashtable_t
 {
-	unsigned		size;
+	unsigned		size;		/* power of two */
+	unsigned		shift;		/* 32 - log2(size) */
 	unsigned		nnodes;
-	pgm_hashnode_t**	nodes;
+	pgm_hashnode_t*		nodes;
 	pgm_hashfunc_t		hash_func;
 	pgm_equalfunc_t		key_equal_func;
 };
 
+/* grow above 3/4 load, shrink below 1/8 */
 #define PGM_HASHTABLE_RESIZE(hash_table) \
 	do { \
-		if ( (hash_table->size >= 3 * hash_table->nnodes && hash_table->size > HASHTABLE_MIN_SIZE) || \
-		     (3 * hash_table->size <= hash_table->nnodes && hash_table->size < HASHTABLE_MAX_SIZE) ) \
-		{ \
-			pgm_hashtable_resize (hash_table); \
-		} \
+		if (4 * hash_table->nnodes > 3 * hash_table->size && hash_table->size < HASHTABLE_MAX_SIZE) \
+			pgm_hashtable_resize (hash_table, 2 * hash_table->size); \
+		else if (8 * hash_table->nnodes < hash_table->size && hash_table->size > HASHTABLE_MIN_SIZE) \
+			pgm_hashtable_resize (hash_table, hash_table->size / 2); \
 	} while (0)
 
-static void pgm_hashtable_resize (pgm_hashtable_t*);
-static pgm_hashnode_t** pgm_hashtable_lookup_node (const pgm_hashtable_t*restrict, const void*restrict, pgm_hash_t*restrict) PGM_GNUC_PURE;
-static pgm_hashnode_t* pgm_hash_node_new (const void*restrict, void*restrict, const pgm_hash_t);
-static void pgm_hash_node_destroy (pgm_hashnode_t*);
-static void pgm_hash_nodes_destroy (pgm_hashnode_t*);
+static void pgm_hashtable_resize (pgm_hashtable_t*, const unsigned);
+static pgm_hashnode_t* pgm_hashtable_lookup_node (const pgm_hashtable_t*restrict, const void*restrict, pgm_hash_t*restrict) PGM_GNUC_PURE;
+static void pgm_hash_node_insert (pgm_hashtable_t*restrict, const void*restrict, void*restrict, const uint32_t);
+
+/* home slot by Fibonacci hashing from the high bits, tolerating weak user
+ * hash functions such as pgm_int_hash.
+ */
+
+static inline
+unsigned
+pgm_hash_node_home (
+	const pgm_hashtable_t*	hash_table,
+	const uint32_t		key_hash
+	)
+{
+	return (uint32_t)(key_hash * 0x9e3779b1U) >> hash_table->shift;
+}
+
+/* probe sequence length of node at index from its home slot.
+ */
+
+static inline
+unsigned
+pgm_hash_node_distance (
+	const pgm_hashtable_t*	hash_table,
+	const uint32_t		key_hash,
+	const unsigned		index_
+	)
+{
+	return (index_ - pgm_hash_node_home (hash_table, key_hash)) & (hash_table->size - 1);
+}
+
+static
+void
+pgm_hashtable_alloc (
+	pgm_hashtable_t*	hash_table,
+	const unsigned		size
+	)
+{
+	unsigned shift = 32;
+
+	for (unsigned i = size; i > 1; i >>= 1)
+		shift--;
+	hash_table->size	= size;
+	hash_table->shift	= shift;
+	hash_table->nodes	= pgm_new0 (pgm_hashnode_t, size);
+}
 
 PGM_GNUC_INTERNAL
 pgm_hashtable_t*
@@ -77,11 +124,10 @@ pgm_hashtable_new (
 	pgm_hashtable_t *hash_table;
   
 	hash_table = pgm_new (pgm_hashtable_t, 1);
-	hash_table->size               = HASHTABLE_MIN_SIZE;
 	hash_table->nnodes             = 0;
 	hash_table->hash_func          = hash_func;
 	hash_table->key_equal_func     = key_equal_func;
-	hash_table->nodes              = pgm_new0 (pgm_hashnode_t*, hash_table->size);
+	pgm_hashtable_alloc (hash_table, HASHTABLE_MIN_SIZE);
   
 	return hash_table;
 }
@@ -94,8 +140,6 @@ pgm_hashtable_unref (
 {
 	pgm_return_if_fail (hash_table != NULL);
 
-	for (unsigned i = 0; i < hash_table->size; i++)
-		pgm_hash_nodes_destroy (hash_table->nodes[i]);
 	pgm_free (hash_table->nodes);
 	pgm_free (hash_table);
 }
@@ -112,8 +156,12 @@ pgm_hashtable_destroy (
 	pgm_hashtable_unref (hash_table);
 }
 
+/* returns node of key, or NULL if not found.  the probe ends at an empty
+ * slot or at a node closer to its home than the key would be.
+ */
+
 static inline
-pgm_hashnode_t**
+pgm_hashnode_t*
 pgm_hashtable_lookup_node (
 	const pgm_hashtable_t* restrict hash_table,
 	const void*	       restrict key,
@@ -121,18 +169,24 @@ pgm_hashtable_lookup_node (
 	)
 {
 	const pgm_hash_t hash_value = (*hash_table->hash_func) (key);
-	pgm_hashnode_t** node = &hash_table->nodes[hash_value % hash_table->size];
+	const uint32_t key_hash = (uint32_t)hash_value;
+	const unsigned mask = hash_table->size - 1;
   
 	if (hash_return)
 		*hash_return = hash_value;
   
-	while (*node && (((*node)->key_hash != hash_value) ||
-                     !(*hash_table->key_equal_func) ((*node)->key, key)))
+	for (unsigned i = pgm_hash_node_home (hash_table, key_hash), distance = 0;
+	     ;
+	     i = (i + 1) & mask, distance++)
 	{
-		node = &(*node)->next;
+		pgm_hashnode_t* node = &hash_table->nodes[i];
+		if (NULL == node->key ||
+		    pgm_hash_node_distance (hash_table, node->key_hash, i) < distance)
+			return NULL;
+		if (node->key_hash == key_hash &&
+		    (*hash_table->key_equal_func) (node->key, key))
+			return node;
 	}
-
-	return node;
 }
 
 PGM_GNUC_INTERNAL
@@ -144,7 +198,7 @@ pgm_hashtable_lookup (
 {
 	pgm_return_val_if_fail (hash_table != NULL, NULL);
   
-	const pgm_hashnode_t* node = *pgm_hashtable_lookup_node (hash_table, key, NULL);
+	const pgm_hashnode_t* node = pgm_hashtable_lookup_node (hash_table, key, NULL);
 	return node ? node->value : NULL;
 }
 
@@ -158,7 +212,7 @@ pgm_hashtable_lookup_extended (
 {
 	pgm_return_val_if_fail (hash_table != NULL, NULL);
   
-	const pgm_hashnode_t* node = *pgm_hashtable_lookup_node (hash_table, key, hash_return);
+	const pgm_hashnode_t* node = pgm_hashtable_lookup_node (hash_table, key, hash_return);
 	return node ? node->value : NULL;
 }
 
@@ -170,19 +224,23 @@ pgm_hashtable_insert (
 	void*		 restrict value
 	)
 {
-	pgm_hashnode_t **node;
+	pgm_hashnode_t *node;
 	pgm_hash_t key_hash;
   
 	pgm_return_if_fail (hash_table != NULL);
+	pgm_return_if_fail (key != NULL);
   
 	node = pgm_hashtable_lookup_node (hash_table, key, &key_hash);
-	pgm_return_if_fail (NULL == *node); 
+	pgm_return_if_fail (NULL == node); 
 
-	*node = pgm_hash_node_new (key, value, key_hash);
 	hash_table->nnodes++;
 	PGM_HASHTABLE_RESIZE (hash_table);
+	pgm_hash_node_insert (hash_table, key, value, (uint32_t)key_hash);
 }
 
+/* remove with backward shift of following displaced nodes, no tombstones.
+ */
+
 PGM_GNUC_INTERNAL
 bool
 pgm_hashtable_remove (
@@ -190,16 +248,24 @@ pgm_hashtable_remove (
 	const void*	 restrict key
 	)
 {
-	pgm_hashnode_t **node, *dest;
+	pgm_hashnode_t *node;
   
 	pgm_return_val_if_fail (hash_table != NULL, FALSE);
   
 	node = pgm_hashtable_lookup_node (hash_table, key, NULL);
-	if (*node)
+	if (node)
 	{
-		dest = *node;
-		(*node) = dest->next;
-		pgm_hash_node_destroy (dest);
+		const unsigned mask = hash_table->size - 1;
+		unsigned i = (unsigned)(node - hash_table->nodes);
+		for (;;) {
+			const unsigned next = (i + 1) & mask;
+			if (NULL == hash_table->nodes[next].key ||
+			    0 == pgm_hash_node_distance (hash_table, hash_table->nodes[next].key_hash, next))
+				break;
+			hash_table->nodes[i] = hash_table->nodes[next];
+			i = next;
+		}
+		hash_table->nodes[i].key = NULL;
 		hash_table->nnodes--;
 		PGM_HASHTABLE_RESIZE (hash_table);
 		return TRUE;
@@ -215,11 +281,7 @@ pgm_hashtable_remove_all (
 {
 	pgm_return_if_fail (hash_table != NULL);
 
-	for (unsigned i = 0; i < hash_table->size; i++)
-	{
-		pgm_hash_nodes_destroy (hash_table->nodes[i]);
-		hash_table->nodes[i] = NULL;
-	}
+	memset (hash_table->nodes, 0, hash_table->size * sizeof(pgm_hashnode_t));
 	hash_table->nnodes = 0;
 	PGM_HASHTABLE_RESIZE (hash_table);
 }
@@ -227,62 +289,59 @@ pgm_hashtable_remove_all (
 static
 void
 pgm_hashtable_resize (
-	pgm_hashtable_t*	hash_table
+	pgm_hashtable_t*	hash_table,
+	const unsigned		new_size
 	)
 {
-	const unsigned new_size = CLAMP (pgm_spaced_primes_closest (hash_table->nnodes),
-					 HASHTABLE_MIN_SIZE, HASHTABLE_MAX_SIZE);
-	pgm_hashnode_t** new_nodes = pgm_new0 (pgm_hashnode_t*, new_size);
-  
-	for (unsigned i = 0; i < hash_table->size; i++)
-		for (pgm_hashnode_t *node = hash_table->nodes[i], *next; node; node = next)
-		{
-			next = node->next;
-			const pgm_hash_t hash_val = node->key_hash % new_size;
-			node->next = new_nodes[hash_val];
-			new_nodes[hash_val] = node;
-		}
-  
-	pgm_free (hash_table->nodes);
-	hash_table->nodes = new_nodes;
-	hash_table->size = new_size;
+	pgm_hashnode_t* old_nodes = hash_table->nodes;
+	const unsigned old_size = hash_table->size;
+	unsigned size = new_size;
+
+/* shrink directly to the minimum after remove_all */
+	while (size > HASHTABLE_MIN_SIZE && 8 * hash_table->nnodes < size / 2)
+		size /= 2;
+	pgm_hashtable_alloc (hash_table, size);
+	for (unsigned i = 0; i < old_size; i++)
+		if (NULL != old_nodes[i].key)
+			pgm_hash_node_insert (hash_table, old_nodes[i].key, old_nodes[i].value, old_nodes[i].key_hash);
+	pgm_free (old_nodes);
 }
 
-static
-pgm_hashnode_t*
-pgm_hash_node_new (
-	const void* restrict key,
-	void* 	    restrict value,
-	const pgm_hash_t     key_hash
-	)
-{
-	pgm_hashnode_t *hash_node = pgm_new (pgm_hashnode_t, 1);
-	hash_node->key = key;
-	hash_node->value = value;
-	hash_node->key_hash = key_hash;
-	hash_node->next = NULL;
-	return hash_node;
-}
-
-static
-void
-pgm_hash_node_destroy (
-	pgm_hashnode_t*	hash_node
-	)
-{
-	pgm_free (hash_node);
-}
+/* place a key known to be absent, displacing nodes nearer to their home
+ * slot so that probe lengths stay even.
+ */
 
 static
 void
-pgm_hash_nodes_destroy (
-	pgm_hashnode_t*	hash_node
+pgm_hash_node_insert (
+	pgm_hashtable_t* restrict hash_table,
+	const void*	 restrict key,
+	void* 		 restrict value,
+	const uint32_t		  key_hash
 	)
 {
-	while (hash_node) {
-		pgm_hashnode_t *next = hash_node->next;
-		pgm_free (hash_node);
-		hash_node = next;
+	const unsigned mask = hash_table->size - 1;
+	pgm_hashnode_t entry;
+
+	entry.key	= key;
+	entry.value	= value;
+	entry.key_hash	= key_hash;
+	for (unsigned i = pgm_hash_node_home (hash_table, key_hash), distance = 0;
+	     ;
+	     i = (i + 1) & mask, distance++)
+	{
+		pgm_hashnode_t* node = &hash_table->nodes[i];
+		if (NULL == node->key) {
+			*node = entry;
+			return;
+		}
+		const unsigned node_distance = pgm_hash_node_distance (hash_table, node->key_hash, i);
+		if (node_distance < distance) {
+			const pgm_hashnode_t swap = *node;
+			*node = entry;
+			entry = swap;
+			distance = node_distance;
+		}
 	}
 }
 
@@ -0,0 +1,270 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for portable hashtable.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+#define TEST_KEYS		1000
+
+/* mock functions for external references */
+
+size_t
+pgm_transport_pkt_offset2 (
+        const bool                      can_fragment,
+        const bool                      use_pgmcc
+        )
+{
+        return 0;
+}
+
+#define HASHTABLE_DEBUG
+#include "hashtable.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+static int keys[ TEST_KEYS ];
+
+static
+void
+mock_setup (void)
+{
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		keys[i] = i;
+}
+
+/* target:
+ *	pgm_hashtable_t*
+ *	pgm_hashtable_new (
+ *		pgm_hashfunc_t		hash_func,
+ *		pgm_equalfunc_t		key_equal_func
+ *	)
+ */
+
+START_TEST (test_new_pass_001)
+{
+	pgm_hashtable_t* hash_table = pgm_hashtable_new (pgm_int_hash, pgm_int_equal);
+	fail_if (NULL == hash_table, "new failed");
+	pgm_hashtable_destroy (hash_table);
+}
+END_TEST
+
+START_TEST (test_new_fail_001)
+{
+	fail_unless (NULL == pgm_hashtable_new (NULL, pgm_int_equal), "new failed");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_hashtable_insert (
+ *		pgm_hashtable_t*	hash_table,
+ *		const void*		key,
+ *		void*			value
+ *	)
+ */
+
+/* grows past minimum size and every key remains reachable */
+START_TEST (test_insert_pass_001)
+{
+	pgm_hashtable_t* hash_table = pgm_hashtable_new (pgm_int_hash, pgm_int_equal);
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		pgm_hashtable_insert (hash_table, &keys[i], &keys[i]);
+	fail_unless (TEST_KEYS == hash_table->nnodes, "insert failed");
+	fail_unless (4 * hash_table->nnodes <= 3 * hash_table->size, "load factor exceeded");
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		fail_unless (&keys[i] == pgm_hashtable_lookup (hash_table, &keys[i]), "lookup failed");
+	pgm_hashtable_destroy (hash_table);
+}
+END_TEST
+
+/* duplicate key */
+START_TEST (test_insert_fail_001)
+{
+	pgm_hashtable_t* hash_table = pgm_hashtable_new (pgm_int_hash, pgm_int_equal);
+	pgm_hashtable_insert (hash_table, &keys[1], &keys[1]);
+	pgm_hashtable_insert (hash_table, &keys[1], &keys[2]);
+	fail_unless (1 == hash_table->nnodes, "insert failed");
+	fail_unless (&keys[1] == pgm_hashtable_lookup (hash_table, &keys[1]), "lookup failed");
+	pgm_hashtable_destroy (hash_table);
+}
+END_TEST
+
+/* target:
+ *	void*
+ *	pgm_hashtable_lookup (
+ *		const pgm_hashtable_t*	hash_table,
+ *		const void*		key
+ *	)
+ */
+
+START_TEST (test_lookup_pass_001)
+{
+	pgm_hashtable_t* hash_table = pgm_hashtable_new (pgm_int_hash, pgm_int_equal);
+	const int missing = TEST_KEYS;
+	for (unsigned i = 0; i < TEST_KEYS; i += 2)
+		pgm_hashtable_insert (hash_table, &keys[i], &keys[i]);
+	for (unsigned i = 1; i < TEST_KEYS; i += 2)
+		fail_unless (NULL == pgm_hashtable_lookup (hash_table, &keys[i]), "lookup failed");
+	fail_unless (NULL == pgm_hashtable_lookup (hash_table, &missing), "lookup failed");
+	pgm_hashtable_destroy (hash_table);
+}
+END_TEST
+
+START_TEST (test_lookup_fail_001)
+{
+	fail_unless (NULL == pgm_hashtable_lookup (NULL, &keys[0]), "lookup failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_hashtable_remove (
+ *		pgm_hashtable_t*	hash_table,
+ *		const void*		key
+ *	)
+ */
+
+/* removal shifts displaced keys back, remaining keys stay reachable */
+START_TEST (test_remove_pass_001)
+{
+	pgm_hashtable_t* hash_table = pgm_hashtable_new (pgm_int_hash, pgm_int_equal);
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		pgm_hashtable_insert (hash_table, &keys[i], &keys[i]);
+	for (unsigned i = 0; i < TEST_KEYS; i += 3)
+		fail_unless (TRUE == pgm_hashtable_remove (hash_table, &keys[i]), "remove failed");
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		fail_unless ((0 == i % 3 ? NULL : &keys[i]) == pgm_hashtable_lookup (hash_table, &keys[i]), "lookup failed");
+	fail_unless (FALSE == pgm_hashtable_remove (hash_table, &keys[0]), "remove failed");
+/* shrinks back to minimum size */
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		pgm_hashtable_remove (hash_table, &keys[i]);
+	fail_unless (0 == hash_table->nnodes, "remove failed");
+	fail_unless (HASHTABLE_MIN_SIZE == hash_table->size, "shrink failed");
+	pgm_hashtable_destroy (hash_table);
+}
+END_TEST
+
+START_TEST (test_remove_fail_001)
+{
+	fail_unless (FALSE == pgm_hashtable_remove (NULL, &keys[0]), "remove failed");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_hashtable_remove_all (
+ *		pgm_hashtable_t*	hash_table
+ *	)
+ */
+
+START_TEST (test_remove_all_pass_001)
+{
+	pgm_hashtable_t* hash_table = pgm_hashtable_new (pgm_int_hash, pgm_int_equal);
+	for (unsigned i = 0; i < TEST_KEYS; i++)
+		pgm_hashtable_insert (hash_table, &keys[i], &keys[i]);
+	pgm_hashtable_remove_all (hash_table);
+	fail_unless (0 == hash_table->nnodes, "remove_all failed");
+	fail_unless (HASHTABLE_MIN_SIZE == hash_table->size, "remove_all failed");
+	fail_unless (NULL == pgm_hashtable_lookup (hash_table, &keys[1]), "lookup failed");
+	pgm_hashtable_insert (hash_table, &keys[1], &keys[1]);
+	fail_unless (&keys[1] == pgm_hashtable_lookup (hash_table, &keys[1]), "lookup failed");
+	pgm_hashtable_destroy (hash_table);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_new = tcase_create ("new");
+	suite_add_tcase (s, tc_new);
+	tcase_add_test (tc_new, test_new_pass_001);
+	tcase_add_test (tc_new, test_new_fail_001);
+
+	TCase* tc_insert = tcase_create ("insert");
+	suite_add_tcase (s, tc_insert);
+	tcase_add_checked_fixture (tc_insert, mock_setup, NULL);
+	tcase_add_test (tc_insert, test_insert_pass_001);
+	tcase_add_test (tc_insert, test_insert_fail_001);
+
+	TCase* tc_lookup = tcase_create ("lookup");
+	suite_add_tcase (s, tc_lookup);
+	tcase_add_checked_fixture (tc_lookup, mock_setup, NULL);
+	tcase_add_test (tc_lookup, test_lookup_pass_001);
+	tcase_add_test (tc_lookup, test_lookup_fail_001);
+
+	TCase* tc_remove = tcase_create ("remove");
+	suite_add_tcase (s, tc_remove);
+	tcase_add_checked_fixture (tc_remove, mock_setup, NULL);
+	tcase_add_test (tc_remove, test_remove_pass_001);
+	tcase_add_test (tc_remove, test_remove_fail_001);
+
+	TCase* tc_remove_all = tcase_create ("remove-all");
+	suite_add_tcase (s, tc_remove_all);
+	tcase_add_checked_fixture (tc_remove_all, mock_setup, NULL);
+	tcase_add_test (tc_remove_all, test_remove_all_pass_001);
+
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
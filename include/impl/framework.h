@@ -69,6 +69,7 @@
 #include <impl/rate_control.h>
 #include <impl/reed_solomon.h>
 #include <impl/security.h>
+#include <impl/skbuff.h>
 #include <impl/slist.h>
 #include <impl/sn.h>
 #include <impl/sockaddr.h>
@@ -31,6 +31,8 @@ PGM_BEGIN_DECLS
 
 PGM_GNUC_INTERNAL void pgm_mem_init (void);
 PGM_GNUC_INTERNAL void pgm_mem_shutdown (void);
+PGM_GNUC_INTERNAL void* pgm_mem_map (size_t*const, const size_t, const bool) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_mem_unmap (void*, const size_t);
 
 PGM_END_DECLS
 
@@ -33,6 +33,8 @@
 PGM_BEGIN_DECLS
 
 PGM_GNUC_INTERNAL ssize_t pgm_sendto_hops (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, bool, int, const void*restrict, size_t, const struct sockaddr*restrict, socklen_t);
+PGM_GNUC_INTERNAL size_t pgm_sendmmsg (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, bool, const struct pgm_iovec*restrict, struct pgm_sk_buff_t*const*, size_t, const struct sockaddr*restrict, socklen_t);
+PGM_GNUC_INTERNAL void pgm_zerocopy_reap (pgm_sock_t*);
 PGM_GNUC_INTERNAL int pgm_set_nonblocking (SOCKET fd[2]);
 
 static inline
@@ -99,6 +99,8 @@ struct pgm_peer_t {
 	pgm_rxw_t*      restrict      	window;
 	pgm_list_t			peers_link;
 	pgm_slist_t			pending_link;
+	unsigned			heap_index;		/* position in pgm_sock_t::peers_heap */
+	pgm_time_t			next_expiry;		/* heap key, never later than any timer */
 
 	unsigned			is_fec_enabled:1;
 	unsigned			has_proactive_parity:1;	    /* indicating availability from this source */
@@ -133,6 +135,7 @@ PGM_GNUC_INTERNAL void pgm_peer_set_pending (pgm_sock_t*const restrict, pgm_peer
 PGM_GNUC_INTERNAL bool pgm_check_peer_state (pgm_sock_t*const, const pgm_time_t);
 PGM_GNUC_INTERNAL void pgm_set_reset_error (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_msgv_t*const restrict);
 PGM_GNUC_INTERNAL pgm_time_t pgm_min_receiver_expiry (pgm_sock_t*, pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_peer_update_expiry (pgm_sock_t*const restrict, pgm_peer_t*const restrict);
 PGM_GNUC_INTERNAL bool pgm_on_peer_nak (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL bool pgm_on_data (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL bool pgm_on_ncf (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -35,17 +35,31 @@ typedef struct pgm_rs_t pgm_rs_t;
 
 PGM_BEGIN_DECLS
 
+/* inverted recovery matrices of recent erasure patterns, most recent first */
+#define PGM_RS_RM_CACHE		4
+
+struct pgm_rs_rm_t {
+	uint8_t*	offsets;	/* erasure pattern, length rs_t::k */
+	pgm_gf8_t*	RM;		/* k × k */
+};
+
 struct pgm_rs_t {
 	uint8_t		n, k;		/* RS(n, k) */
+	bool		is_cauchy;	/* generator from Cauchy rather than Vandermonde matrix */
 	pgm_gf8_t*	GM;
-	pgm_gf8_t*	RM;
+	uint8_t		rm_len;
+	struct pgm_rs_rm_t rm_cache[PGM_RS_RM_CACHE];
 };
 
 #define PGM_RS_DEFAULT_N	255
 
+PGM_GNUC_INTERNAL void pgm_rs_init (void);
 PGM_GNUC_INTERNAL void pgm_rs_create (pgm_rs_t*, const uint8_t, const uint8_t);
+PGM_GNUC_INTERNAL void pgm_rs_create_cauchy (pgm_rs_t*, const uint8_t, const uint8_t);
 PGM_GNUC_INTERNAL void pgm_rs_destroy (pgm_rs_t*);
 PGM_GNUC_INTERNAL void pgm_rs_encode (pgm_rs_t*restrict, const pgm_gf8_t**restrict, const uint8_t, pgm_gf8_t*restrict, const uint16_t);
+PGM_GNUC_INTERNAL void pgm_rs_encode_multi (pgm_rs_t*restrict, const pgm_gf8_t**restrict, const uint8_t, const uint8_t, pgm_gf8_t**restrict, const uint16_t);
+PGM_GNUC_INTERNAL void pgm_rs_encode_fold (pgm_rs_t*restrict, const pgm_gf8_t*restrict, const uint8_t, const uint8_t, const uint8_t, pgm_gf8_t**restrict, const uint16_t);
 PGM_GNUC_INTERNAL void pgm_rs_decode_parity_inline (pgm_rs_t*restrict, pgm_gf8_t**restrict, const uint8_t*restrict, const uint16_t);
 PGM_GNUC_INTERNAL void pgm_rs_decode_parity_appended (pgm_rs_t*restrict, pgm_gf8_t**restrict, const uint8_t*restrict, const uint16_t);
 
@@ -85,6 +85,7 @@ struct pgm_rxw_t {
 	uint32_t		committed_count;	/* but still in window */
 
         uint16_t		max_tpdu;               /* maximum packet size */
+	pgm_skb_pool_t*		skb_pool;		/* placeholders, NULL for heap */
         uint32_t		lead, trail;
         uint32_t		rxw_trail, rxw_trail_init;
 	uint32_t		commit_lead;
@@ -111,6 +112,9 @@ struct pgm_rxw_t {
 
 	size_t			size;			/* in bytes */
 	unsigned		alloc;			/* in pkts */
+/* per sequence state indexed as pdata, one bit per entry */
+	uint32_t*		missing_bitmap;		/* placeholder or lost */
+	uint32_t*		data_bitmap;		/* original data received */
 /* C90 and older */
 	struct pgm_sk_buff_t*   pdata[1];
 };
@@ -118,6 +122,7 @@ struct pgm_rxw_t {
 
 PGM_GNUC_INTERNAL pgm_rxw_t* pgm_rxw_create (const pgm_tsi_t*const, const uint16_t, const unsigned, const unsigned, const ssize_t, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_destroy (pgm_rxw_t*const);
+PGM_GNUC_INTERNAL int pgm_rxw_admit (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL int pgm_rxw_add (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_add_ack (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const pgm_time_t);
 PGM_GNUC_INTERNAL void pgm_rxw_remove_ack (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
@@ -125,7 +130,7 @@ PGM_GNUC_INTERNAL void pgm_rxw_remove_commit (pgm_rxw_t*const);
 PGM_GNUC_INTERNAL ssize_t pgm_rxw_readv (pgm_rxw_t*const restrict, struct pgm_msgv_t** restrict, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL unsigned pgm_rxw_remove_trail (pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL unsigned pgm_rxw_update (pgm_rxw_t*const, const uint32_t, const uint32_t, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
-PGM_GNUC_INTERNAL void pgm_rxw_update_fec (pgm_rxw_t*const, const uint8_t);
+PGM_GNUC_INTERNAL void pgm_rxw_update_fec (pgm_rxw_t*const, const uint8_t, const bool);
 PGM_GNUC_INTERNAL int pgm_rxw_confirm (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_lost (pgm_rxw_t*const, const uint32_t);
 PGM_GNUC_INTERNAL void pgm_rxw_state (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const int);
@@ -0,0 +1,62 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ * 
+ * per-socket pool of fixed size socket buffers
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#       error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_SKBUFF_H__
+#define __PGM_IMPL_SKBUFF_H__
+
+typedef struct pgm_skb_pool_t pgm_skb_pool_t;
+
+#include <pgm/types.h>
+#include <pgm/skbuff.h>
+#include <impl/thread.h>
+
+PGM_BEGIN_DECLS
+
+struct pgm_skb_pool_t {
+	pgm_spinlock_t		lock;
+	struct pgm_sk_buff_t*	free_list;	/* chained through link_.data */
+	uint16_t		size;		/* slab data size, i.e. max_tpdu */
+	unsigned		depth;		/* slabs on free list */
+	unsigned		max_depth;
+	unsigned		outstanding;	/* slabs held by callers */
+	bool			is_destroyed;
+	uint32_t		hits;
+	uint32_t		misses;
+/* pre-faulted slabs of max_depth, NULL when taken from heap on demand */
+	char*			region;
+	size_t			region_len;
+};
+
+PGM_GNUC_INTERNAL pgm_skb_pool_t* pgm_skb_pool_create (uint16_t, unsigned, size_t, bool) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_skb_pool_destroy (pgm_skb_pool_t*);
+PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_skb_pool_alloc (pgm_skb_pool_t*const, const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_skb_pool_stats (pgm_skb_pool_t*const restrict, struct pgm_skbpoolinfo_t*const restrict);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_SKBUFF_H__ */
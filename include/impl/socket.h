@@ -37,6 +37,40 @@ PGM_BEGIN_DECLS
 #	define IP_MAX_MEMBERSHIPS	20
 #endif
 
+#ifndef PGM_MAX_RECV_BATCH
+#	define PGM_MAX_RECV_BATCH	64
+#endif
+
+#ifndef PGM_MAX_ZEROCOPY
+#	define PGM_MAX_ZEROCOPY		1024
+#endif
+
+/* MSG_ZEROCOPY completions are read from the Linux socket error queue, sends
+ * require both the socket option and the send flag.
+ */
+#if defined(HAVE_SENDMMSG) && defined(HAVE_LINUX_ERRQUEUE_H) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#	define USE_ZEROCOPY
+#endif
+
+/* one packet of a batched receive */
+struct pgm_rx_slot_t {
+	struct pgm_sk_buff_t*		skb;
+	ssize_t				len;		/* -1 on discarded packet */
+	struct sockaddr_storage		src_addr;
+	struct sockaddr_storage		dst_addr;
+	char				aux[ 256 ];	/* ancillary data */
+#ifdef HAVE_LINUX_IO_URING_H
+	struct msghdr			msg;		/* io_uring request in flight */
+	struct pgm_iovec		iov;
+#endif
+};
+
+/* one skbuff awaiting MSG_ZEROCOPY completion */
+struct pgm_zc_slot_t {
+	uint32_t			id;		/* kernel notification id */
+	struct pgm_sk_buff_t*		skb;		/* NULL on completed */
+};
+
 struct pgm_sock_t {
 	sa_family_t			family;				/* communications domain */
 	int				socket_type;
@@ -51,7 +85,7 @@ struct pgm_sock_t {
 	pgm_mutex_t			receiver_mutex;			/* receiver API */
 	pgm_mutex_t			source_mutex;			/* source API */
 	pgm_spinlock_t			txw_spinlock;			/* transmit window */
-	pgm_mutex_t			send_mutex;			/* non-router alert socket */
+	pgm_mutex_t			send_mutex;			/* hop limit socket option */
 	pgm_mutex_t			timer_mutex;			/* next timer expiration */
 
 	bool				is_bound;
@@ -65,6 +99,13 @@ struct pgm_sock_t {
 	bool				can_recv_data;			/* send-only */
 	bool				is_edge_triggered_recv;
 	bool				is_nonblocking;
+	bool				use_send_batch;			/* sendmmsg() fragments */
+	bool				use_udp_gso;			/* UDP_SEGMENT fragments */
+	bool				use_udp_gro;			/* UDP_GRO receive */
+	bool				no_hops_cmsg;			/* IP_TTL ancillary data unsupported */
+	bool				use_zerocopy;			/* MSG_ZEROCOPY fragments */
+	bool				use_io_uring;			/* io_uring receive */
+	bool				use_kernel_tstamp;		/* SO_TIMESTAMPNS receive */
 
 	struct group_source_req		send_gsr;			/* multicast */
 	struct sockaddr_storage		send_addr;			/* unicast nla */
@@ -122,7 +163,6 @@ struct pgm_sock_t {
 	pgm_notify_t			ack_notify;
 	pgm_notify_t			rdata_notify;
 
-	pgm_hash_t			last_hash_key;
 	void* restrict			last_hash_value;
 	unsigned			last_commit;
 	size_t				blocklen;		    /* length of buffer blocked */
@@ -140,6 +180,9 @@ struct pgm_sock_t {
 		unsigned			vector_index;
 		size_t				vector_offset;
 		bool				is_rate_limited;
+		struct pgm_sk_buff_t*		batch[PGM_MAX_FRAGMENTS];	/* fragments pending batch send */
+		unsigned			batch_len;
+		unsigned			batch_offset;	/* first unsent fragment */
 	} pkt_dontwait_state;
 
 	uint32_t			spm_sqn;
@@ -158,15 +201,41 @@ struct pgm_sock_t {
 	bool				use_proactive_parity;
 	bool				use_ondemand_parity;
 	bool				use_var_pktlen;
+	bool				use_cauchy_parity;	    /* Cauchy generator matrix */
+	bool				use_checksum_offload;	    /* trust UDP checksum, pgm_checksum = 0 */
+	bool				has_warned_checksum_offload;
+	bool				use_session_filter;	    /* kernel filter of other sessions */
+	uint16_t			recv_shard_count;	    /* 0 or 1 = all sessions */
+	uint16_t			recv_shard_index;
+	unsigned			skb_pool_depth;		    /* 0 = heap allocation */
+	pgm_skb_pool_t*			skb_pool;
+	size_t				hugepage_size;		    /* 0 = heap allocation */
+	bool				use_mlock;
 	uint8_t				rs_n;
 	uint8_t				rs_k;
 	uint8_t				rs_proactive_h;		    /* 0 <= proactive-h <= ( n - k ) */
 	uint8_t				tg_sqn_shift;
 	struct pgm_sk_buff_t* restrict	rx_buffer;
+	struct pgm_rx_slot_t* restrict	rx_ring;		    /* recvmmsg() batch */
+	unsigned			rx_ring_size;
+	unsigned			rx_ring_len;		    /* packets in batch */
+	unsigned			rx_ring_offset;		    /* next packet to demux */
+	char* restrict			rx_gro_buffer;		    /* re-split misaligned segments */
+	struct pgm_uring_t* restrict	rx_uring;		    /* receives in flight */
+	unsigned			rx_uring_order[ PGM_MAX_RECV_BATCH ];	/* slots in completion order */
+	unsigned			rx_uring_rearm[ PGM_MAX_RECV_BATCH ];	/* slots not yet queued */
+	unsigned			rx_uring_rearm_len;
+	struct pgm_zc_slot_t* restrict	zc_ring;		    /* MSG_ZEROCOPY in flight */
+	unsigned			zc_head;
+	unsigned			zc_len;
+	uint32_t			zc_next_id;
 
 	pgm_rwlock_t			peers_lock;
 	pgm_hashtable_t* restrict	peers_hashtable;	    /* fast lookup */
 	pgm_list_t*      restrict	peers_list;		    /* easy iteration */
+	struct pgm_peer_t** restrict	peers_heap;		    /* min-heap on next expiry */
+	unsigned			peers_heap_len;
+	unsigned			peers_heap_size;
 	pgm_slist_t*     restrict	peers_pending;		    /* rxw: have or lost data */
 	pgm_notify_t			pending_notify;		    /* timer to rx */
 	bool				is_pending_read;
@@ -47,6 +47,7 @@ extern pgm_time_update_func		pgm_time_update_now;
 
 PGM_GNUC_INTERNAL bool pgm_time_init (pgm_error_t**) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL bool pgm_time_shutdown (void);
+PGM_GNUC_INTERNAL pgm_time_t pgm_time_from_wallclock (const pgm_time_t);
 
 PGM_END_DECLS
 
@@ -44,6 +44,15 @@ struct pgm_txw_state_t {
 	uint8_t		pkt_cnt_sent;		/* # parity packets already sent */
 };
 
+/* proactive parity packets of recently closed transmission groups */
+#define PGM_TXW_PARITY_TGS	4
+
+struct pgm_txw_parity_t {
+	uint32_t			tg_sqn;
+	bool				is_valid;
+	struct pgm_sk_buff_t**		skb;			/* length pgm_txw_t::rs_proactive_h */
+};
+
 struct pgm_txw_t {
 	const pgm_tsi_t* restrict	tsi;
 
@@ -55,7 +64,18 @@ struct pgm_txw_t {
 
 	pgm_rs_t			rs;
 	uint8_t				tg_sqn_shift;
-	struct pgm_sk_buff_t* restrict	parity_buffer;
+/* parity packets of one transmission group, encoded together */
+	struct pgm_sk_buff_t** restrict	parity_cache;		/* length rs_t::n - rs_t::k */
+	uint32_t			parity_tg_sqn;
+	uint8_t				parity_first;		/* first cached parity index */
+	uint8_t				parity_cnt;		/* zero when cache is empty */
+	uint8_t				rs_proactive_h;
+	struct pgm_txw_parity_t		proactive[PGM_TXW_PARITY_TGS];
+/* open transmission group folded into proactive parity as each packet is added */
+	uint16_t			parity_acc_len;		/* longest TSDU folded */
+	unsigned			parity_acc_is_var_pktlen:1;
+	unsigned			parity_acc_is_op_encoded:1;
+	uint16_t*			parity_acc_tsdu_length;	/* length rs_t::k */
 
 /* Advance with data */
 	pgm_time_t			adv_ivl_expiry;	
@@ -67,12 +87,13 @@ struct pgm_txw_t {
 	unsigned			adv_mode:1;		/* 0 = advance by time, 1 = advance by data */
 
 	size_t				size;			/* window content size in bytes */
+	size_t				map_len;		/* mapped bytes, 0 when on heap */
 	unsigned			alloc;			/* length of pdata[] */
 /* C90 and older */
 	struct pgm_sk_buff_t*		pdata[1];
 };
 
-PGM_GNUC_INTERNAL pgm_txw_t* pgm_txw_create (const pgm_tsi_t*const, const uint16_t, const uint32_t, const unsigned, const ssize_t, const bool, const uint8_t, const uint8_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL pgm_txw_t* pgm_txw_create (const pgm_tsi_t*const, const uint16_t, const uint32_t, const unsigned, const ssize_t, const bool, const uint8_t, const uint8_t, const uint8_t, const bool, const size_t, const bool) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_txw_shutdown (pgm_txw_t*const);
 PGM_GNUC_INTERNAL void pgm_txw_add (pgm_txw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_txw_peek (const pgm_txw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -95,6 +116,7 @@ static inline uint32_t pgm_txw_lead_atomic (const pgm_txw_t* const) PGM_GNUC_WAR
 static inline uint32_t pgm_txw_next_lead (const pgm_txw_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_txw_trail (const pgm_txw_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_txw_trail_atomic (const pgm_txw_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline bool pgm_txw_is_tg_boundary (const pgm_txw_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
 
 static inline
 size_t
@@ -197,6 +219,26 @@ pgm_txw_trail_atomic (
 	return pgm_atomic_read32 (&window->trail);
 }
 
+/* the next packet added opens or closes a transmission group, replacing or
+ * publishing proactive parity in buffers shared with the retransmit path.
+ */
+
+static inline
+bool
+pgm_txw_is_tg_boundary (
+	const pgm_txw_t*const window
+	)
+{
+	uint32_t tg_sqn_mask, next_lead;
+
+	pgm_assert (NULL != window);
+	if (!window->rs_proactive_h)
+		return FALSE;
+	tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
+	next_lead = pgm_txw_next_lead (window);
+	return !(next_lead & ~tg_sqn_mask) || !((next_lead + 1) & ~tg_sqn_mask);
+}
+
 PGM_END_DECLS
 
 #endif /* __PGM_IMPL_TXW_H__ */
@@ -0,0 +1,76 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * io_uring asynchronous receive ring.
+ *
+ * Copyright (c) 2006-2010 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_URING_H__
+#define __PGM_IMPL_URING_H__
+
+typedef struct pgm_uring_t pgm_uring_t;
+
+#include <impl/framework.h>
+#include <impl/socket.h>
+
+PGM_BEGIN_DECLS
+
+#ifdef HAVE_LINUX_IO_URING_H
+struct pgm_uring_t {
+	int			fd;
+	unsigned		to_submit;	/* queued SQEs not yet entered */
+/* submission queue */
+	unsigned*		sq_head;
+	unsigned*		sq_tail;
+	unsigned*		sq_mask;
+	unsigned*		sq_array;
+	struct io_uring_sqe*	sqes;
+/* completion queue */
+	unsigned*		cq_head;
+	unsigned*		cq_tail;
+	unsigned*		cq_mask;
+	struct io_uring_cqe*	cqes;
+/* mappings */
+	void*			sq_ring;
+	size_t			sq_ring_size;
+	void*			cq_ring;
+	size_t			cq_ring_size;
+	size_t			sqes_size;
+};
+
+PGM_GNUC_INTERNAL pgm_uring_t* pgm_uring_create (unsigned);
+PGM_GNUC_INTERNAL void pgm_uring_destroy (pgm_uring_t*);
+PGM_GNUC_INTERNAL bool pgm_uring_recv_slot (pgm_uring_t*restrict, SOCKET, struct pgm_rx_slot_t*restrict, unsigned, size_t);
+PGM_GNUC_INTERNAL int pgm_uring_submit (pgm_uring_t*);
+PGM_GNUC_INTERNAL bool pgm_uring_reap (pgm_uring_t*restrict, unsigned*restrict, int*restrict);
+
+static inline
+int
+pgm_uring_fd (
+	const pgm_uring_t* const uring
+	)
+{
+	return uring->fd;
+}
+#endif /* HAVE_LINUX_IO_URING_H */
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_URING_H__ */
@@ -272,6 +272,7 @@ struct pgm_opt_parity_prm {
 #define PGM_PARITY_PRM_MASK 0x3
 #define PGM_PARITY_PRM_PRO  0x1		/* source provides pro-active parity packets */
 #define PGM_PARITY_PRM_OND  0x2		/*                 on-demand parity packets */
+#define PGM_PARITY_PRM_CAUCHY 0x4	/* extension: Cauchy rather than Vandermonde generator matrix */
 	uint32_t	parity_prm_tgs;		/* transmission group size */
 };
 
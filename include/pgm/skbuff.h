@@ -28,6 +28,7 @@
 #include <string.h>
 
 struct pgm_sk_buff_t;
+struct pgm_skb_pool_t;
 
 #include <pgm/types.h>
 #include <pgm/atomic.h>
@@ -70,11 +71,13 @@ struct pgm_sk_buff_t {
 				       *end;
 	uint32_t			truesize;
 	volatile uint32_t		users;		/* atomic */
+	struct pgm_skb_pool_t*		pool;		/* owning pool or NULL for heap */
 };
 
 void pgm_skb_over_panic (const struct pgm_sk_buff_t*const, const uint16_t) PGM_GNUC_NORETURN;
 void pgm_skb_under_panic (const struct pgm_sk_buff_t*const, const uint16_t) PGM_GNUC_NORETURN;
 bool pgm_skb_is_valid (const struct pgm_sk_buff_t*const) PGM_GNUC_PURE PGM_GNUC_WARN_UNUSED_RESULT;
+void pgm_skb_pool_release (struct pgm_sk_buff_t*const);
 
 /* attribute __pure__ only valid for platforms with atomic ops.
  * attribute __malloc__ not used as only part of the memory should be aliased.
@@ -125,8 +128,12 @@ pgm_free_skb (
 	struct pgm_sk_buff_t*const skb
 	)
 {
-	if (pgm_atomic_exchange_and_add32 (&skb->users, (uint32_t)-1) == 1)
-		pgm_free (skb);
+	if (pgm_atomic_exchange_and_add32 (&skb->users, (uint32_t)-1) == 1) {
+		if (skb->pool)
+			pgm_skb_pool_release (skb);
+		else
+			pgm_free (skb);
+	}
 }
 
 /* add data */
@@ -218,6 +225,7 @@ pgm_skb_copy (
 	newskb->zero_padded = 0;
 	newskb->truesize = skb->truesize;
 	pgm_atomic_write32 (&newskb->users, 1);
+	newskb->pool = NULL;
 	newskb->head = newskb + 1;
 	newskb->end  = (char*)newskb->head + ((char*)skb->end  - (char*)skb->head);
 	newskb->data = (char*)newskb->head + ((char*)skb->data - (char*)skb->head);
@@ -79,6 +79,18 @@ struct pgm_pgmccinfo_t {
 	uint32_t				ack_c_p;
 };
 
+struct pgm_shardinfo_t {
+	uint16_t				shard_count;
+	uint16_t				shard_index;
+};
+
+struct pgm_skbpoolinfo_t {
+	uint32_t				depth;		/* slabs cached */
+	uint32_t				max_depth;
+	uint32_t				hits;		/* allocations served from cache */
+	uint32_t				misses;		/* allocations from heap */
+};
+
 /* socket options */
 enum {
 	PGM_SEND_SOCK		= 0x2000,
@@ -134,7 +146,22 @@ enum {
 	PGM_UNCONTROLLED_ODATA,
 	PGM_UNCONTROLLED_RDATA,
 	PGM_ODATA_MAX_RTE,
-	PGM_RDATA_MAX_RTE
+	PGM_RDATA_MAX_RTE,
+	PGM_SEND_BATCH,
+	PGM_RECV_BATCH,
+	PGM_UDP_GSO,
+	PGM_UDP_GRO,
+	PGM_ZEROCOPY,
+	PGM_IO_URING,
+	PGM_RECV_TIMESTAMP,
+	PGM_FEC_CAUCHY,
+	PGM_UDP_CSUM_OFFLOAD,
+	PGM_RECV_SHARD,
+	PGM_SKB_POOL,
+	PGM_SKB_POOL_STATS,
+	PGM_HUGEPAGES,
+	PGM_MLOCK,
+	PGM_SESSION_FILTER
 };
 
 /* IO status */
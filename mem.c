@@ -27,9 +27,14 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <string.h>
-#ifdef _WIN32
+#ifndef _WIN32
+#	include <errno.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#else
 #	define strcasecmp	stricmp
 #endif
+#include <impl/i18n.h>
 #include <impl/framework.h>
 #include <impl/mem.h>
 
@@ -285,4 +290,105 @@ pgm_free (
 		free (mem);
 }
 
+/* map len bytes of zeroed anonymous memory backed by huge pages of
+ * page_size, falling back to normal pages when none are reserved.  every
+ * page is faulted in before return, and optionally locked into RAM.
+ *
+ * returns address and rounds len up to the mapped size, returns NULL on
+ * error.  release with pgm_mem_unmap().
+ */
+
+PGM_GNUC_INTERNAL
+void*
+pgm_mem_map (
+	size_t*const	len,
+	const size_t	page_size,
+	const bool	use_mlock
+	)
+{
+	char errbuf[1024];
+	char* addr;
+	size_t map_len, stride;
+
+/* pre-conditions */
+	pgm_assert (NULL != len);
+	pgm_assert (*len > 0);
+	pgm_assert (0 == (page_size & (page_size - 1)));
+
+#ifndef _WIN32
+	addr = MAP_FAILED;
+	stride = sysconf (_SC_PAGESIZE);
+#	ifdef MAP_HUGETLB
+	if (page_size > stride) {
+		int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#		ifdef MAP_HUGE_SHIFT
+		flags |= (int)pgm_power2_log2 ((unsigned)page_size) << MAP_HUGE_SHIFT;
+#		endif
+		map_len = (*len + page_size - 1) & ~(page_size - 1);
+		addr = mmap (NULL, map_len, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (MAP_FAILED != addr)
+			stride = page_size;
+		else
+			pgm_trace (PGM_LOG_ROLE_MEMORY,_("Huge pages of %" PRIzu " bytes unavailable: %s"),
+				page_size, pgm_strerror_s (errbuf, sizeof (errbuf), errno));
+	}
+#	endif
+	if (MAP_FAILED == addr) {
+		map_len = (*len + stride - 1) & ~(stride - 1);
+		addr = mmap (NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (MAP_FAILED == addr)
+			return NULL;
+#	ifdef MADV_HUGEPAGE
+/* transparent huge pages before first touch */
+		if (page_size > stride)
+			madvise (addr, map_len, MADV_HUGEPAGE);
+#	endif
+	}
+#else
+	{
+		SYSTEM_INFO si;
+		GetSystemInfo (&si);
+		stride = si.dwPageSize;
+	}
+	map_len = (*len + stride - 1) & ~(stride - 1);
+	addr = VirtualAlloc (NULL, map_len, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (NULL == addr)
+		return NULL;
+#endif
+
+/* pre-fault */
+	for (size_t offset = 0; offset < map_len; offset += stride)
+		((volatile char*)addr)[ offset ] = 0;
+
+	if (use_mlock) {
+#ifndef _WIN32
+		if (0 != mlock (addr, map_len))
+			pgm_trace (PGM_LOG_ROLE_MEMORY,_("Locking %" PRIzu " bytes into memory failed: %s"),
+				map_len, pgm_strerror_s (errbuf, sizeof (errbuf), errno));
+#else
+		if (!VirtualLock (addr, map_len))
+			pgm_trace (PGM_LOG_ROLE_MEMORY,_("Locking %" PRIzu " bytes into memory failed."), map_len);
+#endif
+	}
+	*len = map_len;
+	return addr;
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_mem_unmap (
+	void*		addr,
+	const size_t	len
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != addr);
+
+#ifndef _WIN32
+	munmap (addr, len);
+#else
+	VirtualFree (addr, 0, MEM_RELEASE);
+#endif
+}
+
 /* eof */
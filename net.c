@@ -22,15 +22,24 @@
 #ifdef HAVE_CONFIG_H
 #	include <config.h>
 #endif
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
 #include <errno.h>
 #ifdef HAVE_POLL
 #	include <poll.h>
 #endif
 #ifndef _WIN32
-#	include <sys/socket.h>
+#	include <sys/socket.h>		/* _GNU_SOURCE for struct mmsghdr */
 #	include <netinet/in.h>
+#	include <netinet/udp.h>
 #	include <arpa/inet.h>
 #endif
+#ifdef HAVE_LINUX_ERRQUEUE_H
+#	include <linux/errqueue.h>
+#endif
 #include <impl/i18n.h>
 #include <impl/framework.h>
 #include <impl/net.h>
@@ -40,7 +49,118 @@
 //#define NET_DEBUG
 
 
-/* locked and rate regulated sendto
+/* serialise a send with the hop limit socket option fallback of sendto_hops(),
+ * returns TRUE if sock::send_mutex is taken.
+ */
+
+static inline
+bool
+send_lock (
+	pgm_sock_t* const	sock
+	)
+{
+	if (PGM_LIKELY(!sock->no_hops_cmsg))
+		return FALSE;
+	pgm_mutex_lock (&sock->send_mutex);
+	return TRUE;
+}
+
+/* release sock::send_mutex if taken, preserving errno of the send.
+ */
+
+static inline
+void
+send_unlock (
+	pgm_sock_t* const	sock,
+	const bool		is_locked
+	)
+{
+	if (PGM_LIKELY(!is_locked))
+		return;
+	const int save_errno = pgm_get_last_sock_error();
+	pgm_mutex_unlock (&sock->send_mutex);
+	pgm_set_last_sock_error (save_errno);
+}
+
+/* send one datagram with an optional hop limit, other than -1 the limit is
+ * carried as IP_TTL or IPV6_HOPLIMIT ancillary data for one system call.
+ * kernels without support fall back to setting the socket option before
+ * and after the send, after which every send holds sock::send_mutex so that
+ * no datagram leaves with the briefly changed hop limit.
+ *
+ * on success, returns number of bytes sent.  on error, -1 is returned, and
+ * errno set appropriately.
+ */
+
+static
+ssize_t
+sendto_hops (
+	pgm_sock_t*	       restrict	sock,
+	const SOCKET			send_sock,
+	int				hops,
+	const void*	       restrict	buf,
+	size_t				len,
+	const struct sockaddr* restrict	to,
+	socklen_t			tolen
+	)
+{
+	if (-1 == hops) {
+		const bool is_locked = send_lock (sock);
+		const ssize_t sent = sendto (send_sock, buf, len, 0, to, (socklen_t)tolen);
+		send_unlock (sock, is_locked);
+		return sent;
+	}
+
+#if !defined(_WIN32) && defined(IP_TTL) && defined(IPV6_HOPLIMIT)
+	if (!sock->no_hops_cmsg)
+	{
+		const bool is_ipv6 = (AF_INET6 == pgm_sockaddr_family (to));
+		struct pgm_iovec iov = {
+			.iov_base	= (void*)(uintptr_t)buf,
+			.iov_len	= len
+		};
+		union {
+			char		buf[ CMSG_SPACE(sizeof(int)) ];
+			struct cmsghdr	align;
+		} control;
+		struct msghdr msg = {
+			.msg_name	= (void*)(uintptr_t)to,
+			.msg_namelen	= tolen,
+			.msg_iov	= (struct iovec*)&iov,	/* pgm_iovec matches struct iovec */
+			.msg_iovlen	= 1,
+			.msg_control	= control.buf,
+			.msg_controllen	= sizeof(control.buf),
+			.msg_flags	= 0
+		};
+		struct cmsghdr* cmsg	= CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level	= is_ipv6 ? IPPROTO_IPV6 : IPPROTO_IP;
+		cmsg->cmsg_type		= is_ipv6 ? IPV6_HOPLIMIT : IP_TTL;
+		cmsg->cmsg_len		= CMSG_LEN(sizeof(int));
+		memcpy (CMSG_DATA(cmsg), &hops, sizeof(int));
+
+		const ssize_t sent = sendmsg (send_sock, &msg, 0);
+		if (PGM_LIKELY(sent >= 0 || EINVAL != pgm_get_last_sock_error()))
+			return sent;
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling hop limit ancillary data."));
+		sock->no_hops_cmsg = TRUE;
+	}
+#endif
+
+/* socket default is briefly changed, serialise with all other sends */
+	pgm_mutex_lock (&sock->send_mutex);
+	pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, hops);
+	const ssize_t sent = sendto (send_sock, buf, len, 0, to, (socklen_t)tolen);
+	const int save_errno = pgm_get_last_sock_error();
+/* revert to default value hop limit */
+	pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, sock->hops);
+	pgm_mutex_unlock (&sock->send_mutex);
+	pgm_set_last_sock_error (save_errno);
+	return sent;
+}
+
+/* rate regulated sendto.  no lock is held across the system call unless the
+ * hop limit fallback is active, ODATA from the publisher and RDATA from the
+ * timer thread proceed concurrently.
  *
  * on success, returns number of bytes sent.  on error, -1 is returned, and
  * errno set appropriately.
@@ -103,12 +223,7 @@ pgm_sendto_hops (
 		}
 	}
 
-	if (!use_router_alert && sock->can_send_data)
-		pgm_mutex_lock (&sock->send_mutex);
-	if (-1 != hops)
-		pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, hops);
-
-	ssize_t sent = sendto (send_sock, buf, len, 0, to, (socklen_t)tolen);
+	ssize_t sent = sendto_hops (sock, send_sock, hops, buf, len, to, tolen);
 	pgm_debug ("sendto returned %" PRIzd, sent);
 	if (sent < 0) {
 		int save_errno = pgm_get_last_sock_error();
@@ -141,7 +256,7 @@ pgm_sendto_hops (
 #endif /* HAVE_POLL */
 			if (ready > 0)
 			{
-				sent = sendto (send_sock, buf, len, 0, to, (socklen_t)tolen);
+				sent = sendto_hops (sock, send_sock, hops, buf, len, to, tolen);
 				if ( sent < 0 )
 				{
 					char errbuf[1024];
@@ -169,14 +284,406 @@ pgm_sendto_hops (
 		}
 	}
 
-/* revert to default value hop limit */
-	if (-1 != hops)
-		pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, sock->hops);
-	if (!use_router_alert && sock->can_send_data)
-		pgm_mutex_unlock (&sock->send_mutex);
 	return sent;
 }
 
+#ifdef UDP_SEGMENT
+/* send datagrams as one buffer segmented by the kernel with UDP generic
+ * segmentation offload.  every datagram except the last must be the same size.
+ *
+ * returns TRUE when the vector is sent, or would block setting errno
+ * appropriately, with the count of datagrams sent saved into done.  returns
+ * FALSE if the vector must be sent per datagram.
+ */
+
+static
+bool
+sendmsg_segment (
+	pgm_sock_t*	       restrict	sock,
+	const SOCKET			send_sock,
+	const struct pgm_iovec*restrict	vector,
+	size_t				count,
+	const struct sockaddr* restrict	to,
+	socklen_t			tolen,
+	int				flags,
+	size_t*		       restrict	done
+	)
+{
+	const size_t gso_size = vector[0].iov_len;
+	size_t total_length = 0;
+	union {
+		char		buf[ CMSG_SPACE(sizeof(uint16_t)) ];
+		struct cmsghdr	align;
+	} control;
+
+	for (size_t i = 0; i < count; i++) {
+		if (i < (count - 1) ? vector[i].iov_len != gso_size : vector[i].iov_len > gso_size)
+			return FALSE;
+		total_length += vector[i].iov_len;
+	}
+/* maximum UDP payload */
+	if (total_length > UINT16_MAX - sock->iphdr_len)
+		return FALSE;
+
+	struct msghdr msg = {
+		.msg_name	= (void*)(uintptr_t)to,
+		.msg_namelen	= tolen,
+		.msg_iov	= (struct iovec*)(uintptr_t)vector,	/* pgm_iovec matches struct iovec */
+		.msg_iovlen	= count,
+		.msg_control	= control.buf,
+		.msg_controllen	= sizeof(control.buf),
+		.msg_flags	= 0
+	};
+	struct cmsghdr* cmsg	= CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level	= SOL_UDP;
+	cmsg->cmsg_type		= UDP_SEGMENT;
+	cmsg->cmsg_len		= CMSG_LEN(sizeof(uint16_t));
+	*(uint16_t*)CMSG_DATA(cmsg) = (uint16_t)gso_size;
+
+	ssize_t sent;
+	const bool is_locked = send_lock (sock);
+	do {
+		sent = sendmsg (send_sock, &msg, flags);
+	} while (sent < 0 && PGM_SOCK_EINTR == pgm_get_last_sock_error());
+	send_unlock (sock, is_locked);
+	pgm_debug ("sendmsg returned %" PRIzd, sent);
+	if (sent >= 0) {
+		*done = count;
+		return TRUE;
+	}
+
+	const int save_errno = pgm_get_last_sock_error();
+	if (PGM_SOCK_EAGAIN == save_errno) {	/* would block on non-blocking send */
+		*done = 0;
+		return TRUE;
+	}
+/* kernel or device without segmentation offload, fall back permanently */
+	if (EIO == save_errno || EINVAL == save_errno || ENOPROTOOPT == save_errno || EOPNOTSUPP == save_errno) {
+		char errbuf[1024];
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling UDP segmentation offload: %s"),
+			   pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		sock->use_udp_gso = FALSE;
+	}
+	return FALSE;
+}
+#endif /* UDP_SEGMENT */
+
+#ifdef USE_ZEROCOPY
+/* hold a reference on a skbuff sent with MSG_ZEROCOPY until the kernel
+ * notifies completion of the send with identifier id.
+ */
+
+static
+void
+zerocopy_hold (
+	pgm_sock_t*	      const restrict sock,
+	const uint32_t			     id,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	pgm_assert (sock->zc_len < PGM_MAX_ZEROCOPY);
+	struct pgm_zc_slot_t* slot = &sock->zc_ring[ (sock->zc_head + sock->zc_len++) % PGM_MAX_ZEROCOPY ];
+	slot->id  = id;
+	slot->skb = pgm_skb_get (skb);
+}
+
+/* release skbuffs for the completed send identifiers lo to hi inclusive.
+ * notifications normally arrive in order, out of order ranges are released
+ * in place and skipped when reaching the head.
+ *
+ * a released skbuff may be the head of the retransmit queue, repairs waiting
+ * on it are re-signalled.
+ */
+
+static
+void
+zerocopy_release (
+	pgm_sock_t* const	sock,
+	const uint32_t		lo,
+	const uint32_t		hi
+	)
+{
+	bool is_released = FALSE;
+
+	for (unsigned i = 0; i < sock->zc_len; i++)
+	{
+		struct pgm_zc_slot_t* slot = &sock->zc_ring[ (sock->zc_head + i) % PGM_MAX_ZEROCOPY ];
+		if (pgm_uint32_lt (slot->id, lo))
+			continue;
+		if (pgm_uint32_gt (slot->id, hi))
+			break;
+		if (NULL != slot->skb) {
+			pgm_free_skb (slot->skb);
+			slot->skb = NULL;
+			is_released = TRUE;
+		}
+	}
+	if (is_released && !pgm_txw_retransmit_is_empty (sock->window))
+		pgm_notify_send (&sock->rdata_notify);
+	while (sock->zc_len > 0 && NULL == sock->zc_ring[ sock->zc_head ].skb) {
+		sock->zc_head = (sock->zc_head + 1) % PGM_MAX_ZEROCOPY;
+		sock->zc_len--;
+	}
+}
+
+/* read pending MSG_ZEROCOPY completion notifications from the error queue
+ * without blocking.
+ */
+
+static
+void
+zerocopy_reap (
+	pgm_sock_t* const	sock
+	)
+{
+	while (sock->zc_len > 0)
+	{
+		union {
+			char		buf[ CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6)) ];
+			struct cmsghdr	align;
+		} control;
+		struct msghdr msg = {
+			.msg_control	= control.buf,
+			.msg_controllen	= sizeof(control.buf)
+		};
+		if (recvmsg (sock->send_sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+			return;
+
+		struct cmsghdr* cmsg;
+		for (cmsg = CMSG_FIRSTHDR(&msg);
+		     cmsg != NULL;
+		     cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			if (!(IPPROTO_IP == cmsg->cmsg_level && IP_RECVERR == cmsg->cmsg_type) &&
+			    !(IPPROTO_IPV6 == cmsg->cmsg_level && IPV6_RECVERR == cmsg->cmsg_type))
+				continue;
+			const struct sock_extended_err* serr = (const void*)CMSG_DATA(cmsg);
+			if (0 != serr->ee_errno || SO_EE_ORIGIN_ZEROCOPY != serr->ee_origin)
+				continue;
+/* deferred copy costs more than a plain send, e.g. loopback */
+			if ((serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) && sock->use_zerocopy) {
+				pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling zero-copy transmit on kernel copied payload."));
+				sock->use_zerocopy = FALSE;
+			}
+			zerocopy_release (sock, serr->ee_info, serr->ee_data);
+		}
+	}
+}
+#endif /* USE_ZEROCOPY */
+
+/* reap MSG_ZEROCOPY completions from the repair path, without it skbuffs
+ * held for the kernel are never returned to the transmit window once ODATA
+ * stops and RDATA for them stalls.
+ *
+ * the completion ring is protected by source_mutex, if held the sender reaps
+ * on its next batch.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_zerocopy_reap (
+	PGM_GNUC_UNUSED pgm_sock_t* const	sock
+	)
+{
+#ifdef USE_ZEROCOPY
+	pgm_assert (NULL != sock);
+
+	if (!pgm_mutex_trylock (&sock->source_mutex))
+		return;
+	if (sock->zc_len > 0)
+		zerocopy_reap (sock);
+	pgm_mutex_unlock (&sock->source_mutex);
+#endif
+}
+
+/* rate regulated batch send of one or more datagrams to the same
+ * destination, with sendmmsg() one system call covers the entire vector.
+ *
+ * the rate limit is checked once for the total wire size of the batch.  with
+ * UDP encapsulation the batch may be passed as one segmentation offload buffer.
+ * datagrams failing with network errors are dropped as per pgm_sendto_hops()
+ * and are left for repair by NAK.
+ *
+ * with skbs owning the vector and PGM_ZEROCOPY enabled the payload is sent
+ * with MSG_ZEROCOPY and a reference is held on each skbuff until the kernel
+ * completes the send.  a skbuff is therefore never recycled by the transmit
+ * window, nor re-written for RDATA, while the kernel still reads from it.
+ *
+ * returns number of datagrams consumed, if less than count the remainder
+ * would block and errno is set appropriately.
+ */
+
+PGM_GNUC_INTERNAL
+size_t
+pgm_sendmmsg (
+	pgm_sock_t*	       restrict	sock,
+	bool				use_rate_limit,
+	pgm_rate_t*	       restrict	minor_rate_control,
+	bool				use_router_alert,
+	const struct pgm_iovec*restrict	vector,
+	PGM_GNUC_UNUSED struct pgm_sk_buff_t*const* skbs,	/* optional owners of vector */
+	size_t				count,
+	const struct sockaddr* restrict	to,
+	socklen_t			tolen
+	)
+{
+	size_t done = 0;
+
+	pgm_assert( NULL != sock );
+	pgm_assert( NULL != vector );
+	pgm_assert( count > 0 );
+	pgm_assert( count <= PGM_MAX_FRAGMENTS );
+	pgm_assert( NULL != to );
+	pgm_assert( tolen > 0 );
+
+	if (use_rate_limit)
+	{
+		size_t total_tpdu_length = 0;
+		for (size_t i = 0; i < count; i++)
+			total_tpdu_length += sock->iphdr_len + vector[i].iov_len;
+		total_tpdu_length -= sock->iphdr_len;		/* includes 1 × IP header len */
+		if (NULL == minor_rate_control)
+		{
+			if (!pgm_rate_check (&sock->rate_control, total_tpdu_length, sock->is_nonblocking))
+			{
+				pgm_set_last_sock_error (PGM_SOCK_ENOBUFS);
+				return 0;
+			}
+		}
+		else
+		{
+			if (!pgm_rate_check2 (&sock->rate_control, minor_rate_control, total_tpdu_length, sock->is_nonblocking))
+			{
+				pgm_set_last_sock_error (PGM_SOCK_ENOBUFS);
+				return 0;
+			}
+		}
+	}
+
+#ifdef USE_ZEROCOPY
+	int flags = 0;
+	if (sock->zc_len > 0)
+		zerocopy_reap (sock);
+/* regular socket only, within capacity of the completion ring */
+	if (sock->use_zerocopy && NULL != skbs && !use_router_alert &&
+	    sock->zc_len + count <= PGM_MAX_ZEROCOPY)
+		flags = MSG_ZEROCOPY;
+#elif defined(UDP_SEGMENT) || defined(HAVE_SENDMMSG)
+	const int flags = 0;
+#endif
+
+#ifdef UDP_SEGMENT
+	if (sock->use_udp_gso && !use_router_alert && count > 1)
+	{
+		if (sendmsg_segment (sock, sock->send_sock, vector, count, to, tolen, flags, &done)) {
+#	ifdef USE_ZEROCOPY
+/* one notification for the entire buffer */
+			if (flags && done > 0) {
+				const uint32_t id = sock->zc_next_id++;
+				for (size_t i = 0; i < done; i++)
+					zerocopy_hold (sock, id, skbs[i]);
+			}
+#	endif
+			return done;
+		}
+	}
+#endif
+
+#ifdef HAVE_SENDMMSG
+	const SOCKET send_sock = use_router_alert ? sock->send_with_router_alert_sock : sock->send_sock;
+	struct mmsghdr msgs[PGM_MAX_FRAGMENTS];
+	int save_errno = 0;
+
+	memset (msgs, 0, count * sizeof(struct mmsghdr));
+	for (size_t i = 0; i < count; i++) {
+		msgs[i].msg_hdr.msg_name	= (void*)(uintptr_t)to;
+		msgs[i].msg_hdr.msg_namelen	= tolen;
+		msgs[i].msg_hdr.msg_iov		= (struct iovec*)(uintptr_t)&vector[i];	/* pgm_iovec matches struct iovec */
+		msgs[i].msg_hdr.msg_iovlen	= 1;
+	}
+
+	bool is_retry = FALSE;
+	while (done < count)
+	{
+		const bool is_locked = send_lock (sock);
+		const int sent = sendmmsg (send_sock, &msgs[done], (unsigned)(count - done), flags);
+		send_unlock (sock, is_locked);
+		pgm_debug ("sendmmsg returned %d", sent);
+		if (sent < 0) {
+			save_errno = pgm_get_last_sock_error();
+			if (PGM_SOCK_EINTR == save_errno)
+				continue;
+#	ifdef USE_ZEROCOPY
+/* socket option memory exhausted by outstanding notifications, copy instead */
+			if (PGM_SOCK_ENOBUFS == save_errno && flags) {
+				flags = 0;
+				continue;
+			}
+#	endif
+			if (PGM_SOCK_EAGAIN == save_errno)	/* would block on non-blocking send */
+				break;
+			if (PGM_UNLIKELY(save_errno != PGM_SOCK_ENETUNREACH &&	/* Network is unreachable */
+					 save_errno != PGM_SOCK_EHOSTUNREACH))	/* No route to host */
+			{
+#ifdef HAVE_POLL
+				if (!is_retry) {
+/* poll for cleared socket */
+					struct pollfd p = {
+						.fd		= send_sock,
+						.events		= POLLOUT,
+						.revents	= 0
+					};
+					is_retry = TRUE;
+					if (poll (&p, 1, 500 /* ms */) > 0)
+						continue;
+				}
+#endif
+				char errbuf[1024];
+				char toaddr[INET6_ADDRSTRLEN];
+				pgm_sockaddr_ntop (to, toaddr, sizeof(toaddr));
+				pgm_warn (_("sendmmsg() %s failed: %s"),
+					toaddr,
+					pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			}
+/* drop the failing datagram */
+			is_retry = FALSE;
+			done++;
+			continue;
+		}
+		is_retry = FALSE;
+#	ifdef USE_ZEROCOPY
+		if (flags) {
+			for (int i = 0; i < sent; i++)
+				zerocopy_hold (sock, sock->zc_next_id++, skbs[done + i]);
+		}
+#	endif
+		done += sent;
+	}
+	if (done < count)
+		pgm_set_last_sock_error (save_errno);
+#else
+/* one system call per datagram */
+	while (done < count)
+	{
+		const ssize_t sent = pgm_sendto (sock,
+						 FALSE,
+						 NULL,
+						 use_router_alert,
+						 vector[done].iov_base,
+						 vector[done].iov_len,
+						 to,
+						 tolen);
+		if (sent < 0) {
+			const int save_errno = pgm_get_last_sock_error();
+			if (PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno)
+				break;
+		}
+		done++;
+	}
+#endif /* HAVE_SENDMMSG */
+	return done;
+}
+
 /* socket helper, for setting pipe ends non-blocking
  *
  * on success, returns 0.  on error, returns -1, and sets errno appropriately.
@@ -19,7 +19,14 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
 
+#include <errno.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -27,6 +34,9 @@
 #ifndef _WIN32
 #	include <sys/types.h>
 #	include <sys/socket.h>
+#	include <netinet/in.h>
+#	include <netinet/udp.h>		/* UDP_SEGMENT */
+#	include <sys/ioctl.h>
 #else
 #	include <ws2tcpip.h>
 #	include <mswsock.h>
@@ -43,6 +53,11 @@
 
 #ifndef _WIN32
 ssize_t mock_sendto (int, const void*, size_t, int, const struct sockaddr*, socklen_t);
+ssize_t mock_sendmsg (int, const struct msghdr*, int);
+#	ifdef HAVE_SENDMMSG
+int mock_sendmmsg (int, struct mmsghdr*, unsigned int, int);
+#	endif
+ssize_t mock_recvmsg (int, struct msghdr*, int);
 #else
 int mock_sendto (SOCKET, const char*, int, int, const struct sockaddr*, int);
 int mock_select (int, fd_set*, fd_set*, fd_set*, struct timeval*);
@@ -50,7 +65,11 @@ int mock_select (int, fd_set*, fd_set*, fd_set*, struct timeval*);
 
 
 #define pgm_rate_check		mock_pgm_rate_check
+#define pgm_txw_retransmit_is_empty	mock_pgm_txw_retransmit_is_empty
 #define sendto			mock_sendto
+#define sendmsg			mock_sendmsg
+#define sendmmsg		mock_sendmmsg
+#define recvmsg			mock_recvmsg
 #define poll			mock_poll
 #define select			mock_select
 #define fcntl			mock_fcntl
@@ -58,6 +77,31 @@ int mock_select (int, fd_set*, fd_set*, fd_set*, struct timeval*);
 #define NET_DEBUG
 #include "net.c"
 
+/* errno raised by sendmsg() with a UDP_SEGMENT control message, zero for success */
+static int mock_segment_errno = 0;
+static unsigned mock_segment_calls = 0;
+static unsigned mock_datagrams_sent = 0;
+
+#ifdef USE_ZEROCOPY
+/* MSG_ZEROCOPY completion notifications pending on the socket error queue */
+static struct sock_extended_err mock_errqueue[8];
+static unsigned mock_errqueue_len = 0;
+
+static
+void
+mock_errqueue_push (
+	uint32_t	lo,
+	uint32_t	hi
+	)
+{
+	struct sock_extended_err* serr = &mock_errqueue[ mock_errqueue_len++ ];
+	memset (serr, 0, sizeof(struct sock_extended_err));
+	serr->ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+	serr->ee_info   = lo;
+	serr->ee_data   = hi;
+}
+#endif
+
 
 static
 pgm_sock_t*
@@ -173,6 +217,18 @@ mock_pgm_rate_check (
 	return TRUE;
 }
 
+/* repairs waiting on the transmit window */
+static bool mock_is_retransmit_empty = TRUE;
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_txw_retransmit_is_empty (
+	const pgm_txw_t* const	window
+	)
+{
+	return mock_is_retransmit_empty;
+}
+
 #ifndef _WIN32
 ssize_t
 mock_sendto (
@@ -199,9 +255,84 @@ mock_sendto (
 	pgm_sockaddr_ntop (to, saddr, sizeof(saddr));
 	g_debug ("mock_sendto (s:%i buf:%p len:%u flags:%s to:%s tolen:%d)",
 		s, buf, (unsigned)len, flags_string (flags), saddr, tolen);
+	mock_datagrams_sent++;
 	return len;
 }
 
+#ifndef _WIN32
+ssize_t
+mock_sendmsg (
+	int			s,
+	const struct msghdr*	msg,
+	int			flags
+	)
+{
+	char saddr[INET6_ADDRSTRLEN];
+	const struct cmsghdr* cmsg = CMSG_FIRSTHDR((struct msghdr*)msg);
+	ssize_t len = 0;
+	pgm_sockaddr_ntop (msg->msg_name, saddr, sizeof(saddr));
+	g_debug ("mock_sendmsg (s:%i msg:%p flags:%s to:%s cmsg-level:%d cmsg-type:%d)",
+		s, (gconstpointer)msg, flags_string (flags), saddr,
+		cmsg ? cmsg->cmsg_level : -1, cmsg ? cmsg->cmsg_type : -1);
+#ifdef UDP_SEGMENT
+	if (cmsg && SOL_UDP == cmsg->cmsg_level && UDP_SEGMENT == cmsg->cmsg_type) {
+		mock_segment_calls++;
+		if (mock_segment_errno) {
+			errno = mock_segment_errno;
+			return -1;
+		}
+		mock_datagrams_sent += (unsigned)msg->msg_iovlen;
+	}
+#endif
+	for (size_t i = 0; i < (size_t)msg->msg_iovlen; i++)
+		len += msg->msg_iov[i].iov_len;
+	return len;
+}
+
+#	ifdef HAVE_SENDMMSG
+int
+mock_sendmmsg (
+	int			s,
+	struct mmsghdr*		msgvec,
+	unsigned int		vlen,
+	int			flags
+	)
+{
+	g_debug ("mock_sendmmsg (s:%i msgvec:%p vlen:%u flags:%s)",
+		s, (gpointer)msgvec, vlen, flags_string (flags));
+	for (unsigned i = 0; i < vlen; i++)
+		msgvec[i].msg_len = (unsigned)msgvec[i].msg_hdr.msg_iov[0].iov_len;
+	mock_datagrams_sent += vlen;
+	return (int)vlen;
+}
+#	endif
+
+ssize_t
+mock_recvmsg (
+	int			s,
+	struct msghdr*		msg,
+	int			flags
+	)
+{
+	g_debug ("mock_recvmsg (s:%i msg:%p flags:%s)",
+		s, (gpointer)msg, flags_string (flags));
+#ifdef USE_ZEROCOPY
+	if ((flags & MSG_ERRQUEUE) && mock_errqueue_len > 0) {
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+		cmsg->cmsg_level = IPPROTO_IP;
+		cmsg->cmsg_type  = IP_RECVERR;
+		cmsg->cmsg_len   = CMSG_LEN(sizeof(struct sock_extended_err));
+		memcpy (CMSG_DATA(cmsg), &mock_errqueue[0], sizeof(struct sock_extended_err));
+		msg->msg_controllen = CMSG_SPACE(sizeof(struct sock_extended_err));
+		memmove (&mock_errqueue[0], &mock_errqueue[1], --mock_errqueue_len * sizeof(struct sock_extended_err));
+		return 0;
+	}
+#endif
+	errno = EAGAIN;
+	return -1;
+}
+#endif /* !_WIN32 */
+
 #ifdef HAVE_POLL
 int
 mock_poll (
@@ -350,6 +481,261 @@ START_TEST (test_sendto_fail_005)
 }
 END_TEST
 
+/* target:
+ *	ssize_t
+ *	pgm_sendto_hops (
+ *		pgm_sock_t*		sock,
+ *		bool			use_rate_limit,
+ *		pgm_rate_t*		minor_rate_control,
+ *		bool			use_router_alert,
+ *		int			hops,
+ *		const void*		buf,
+ *		size_t			len,
+ *		const struct sockaddr*	to,
+ *		socklen_t		tolen
+ *	)
+ */
+
+START_TEST (test_sendto_hops_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	const char* buf = "i am not a string";
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	gssize len = pgm_sendto_hops (sock, FALSE, NULL, FALSE, 1, buf, sizeof(buf), (struct sockaddr*)&addr, sizeof(addr));
+	fail_unless (sizeof(buf) == len, "sendto_hops underrun");
+}
+END_TEST
+
+/* target:
+ *	size_t
+ *	pgm_sendmmsg (
+ *		pgm_sock_t*			sock,
+ *		bool				use_rate_limit,
+ *		pgm_rate_t*			minor_rate_control,
+ *		bool				use_router_alert,
+ *		const struct pgm_iovec*		vector,
+ *		struct pgm_sk_buff_t*const*	skbs,
+ *		size_t				count,
+ *		const struct sockaddr*		to,
+ *		socklen_t			tolen
+ *	)
+ */
+
+START_TEST (test_sendmmsg_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	char buf[3][100];
+	struct pgm_iovec vector[3];
+	for (unsigned i = 0; i < G_N_ELEMENTS(vector); i++) {
+		vector[i].iov_base = buf[i];
+		vector[i].iov_len  = sizeof(buf[i]);
+	}
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	mock_datagrams_sent = 0;
+	const size_t sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, NULL, G_N_ELEMENTS(vector), (struct sockaddr*)&addr, sizeof(addr));
+	fail_unless (G_N_ELEMENTS(vector) == sent, "sendmmsg underrun");
+	fail_unless (G_N_ELEMENTS(vector) == mock_datagrams_sent, "unexpected datagram count");
+}
+END_TEST
+
+#ifdef UDP_SEGMENT
+/* segmentation offload unsupported by kernel or device, fall back permanently
+ * to one datagram per message without losing the vector.
+ */
+START_TEST (test_sendmmsg_pass_002)
+{
+	const int errnos[] = { EIO, EINVAL };
+	char buf[3][100];
+	struct pgm_iovec vector[3];
+	for (unsigned i = 0; i < G_N_ELEMENTS(vector); i++) {
+		vector[i].iov_base = buf[i];
+		vector[i].iov_len  = sizeof(buf[i]);
+	}
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	for (unsigned i = 0; i < G_N_ELEMENTS(errnos); i++) {
+		pgm_sock_t* sock = generate_sock ();
+		sock->use_udp_gso = TRUE;
+		mock_segment_errno = errnos[i];
+		mock_segment_calls = 0;
+		mock_datagrams_sent = 0;
+		size_t sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, NULL, G_N_ELEMENTS(vector), (struct sockaddr*)&addr, sizeof(addr));
+		fail_unless (G_N_ELEMENTS(vector) == sent, "sendmmsg underrun");
+		fail_unless (G_N_ELEMENTS(vector) == mock_datagrams_sent, "unexpected datagram count");
+		fail_unless (1 == mock_segment_calls, "segmentation offload not tried");
+		fail_unless (FALSE == sock->use_udp_gso, "segmentation offload not disabled");
+/* no further attempts */
+		sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, NULL, G_N_ELEMENTS(vector), (struct sockaddr*)&addr, sizeof(addr));
+		fail_unless (G_N_ELEMENTS(vector) == sent, "sendmmsg underrun");
+		fail_unless (1 == mock_segment_calls, "segmentation offload retried");
+	}
+	mock_segment_errno = 0;
+}
+END_TEST
+
+/* would block keeps segmentation offload */
+START_TEST (test_sendmmsg_pass_003)
+{
+	pgm_sock_t* sock = generate_sock ();
+	sock->use_udp_gso = TRUE;
+	char buf[3][100];
+	struct pgm_iovec vector[3];
+	for (unsigned i = 0; i < G_N_ELEMENTS(vector); i++) {
+		vector[i].iov_base = buf[i];
+		vector[i].iov_len  = sizeof(buf[i]);
+	}
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	mock_segment_errno = EAGAIN;
+	mock_segment_calls = 0;
+	mock_datagrams_sent = 0;
+	const size_t sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, NULL, G_N_ELEMENTS(vector), (struct sockaddr*)&addr, sizeof(addr));
+	mock_segment_errno = 0;
+	fail_unless (0 == sent, "sendmmsg did not block");
+	fail_unless (0 == mock_datagrams_sent, "unexpected datagram count");
+	fail_unless (EAGAIN == errno, "errno not would-block");
+	fail_unless (TRUE == sock->use_udp_gso, "segmentation offload disabled");
+}
+END_TEST
+#endif /* UDP_SEGMENT */
+
+#ifdef USE_ZEROCOPY
+/* skbuffs are held until the kernel completes the send, completions may be
+ * coalesced into one range, arrive out of order, or refer to sends already
+ * released.
+ *
+ * target:
+ *	void
+ *	pgm_zerocopy_reap (
+ *		pgm_sock_t*			sock
+ *	)
+ */
+
+START_TEST (test_zerocopy_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	sock->use_zerocopy = TRUE;
+	sock->zc_ring = g_new0 (struct pgm_zc_slot_t, PGM_MAX_ZEROCOPY);
+	pgm_mutex_init (&sock->source_mutex);
+	struct pgm_sk_buff_t* skbs[4];
+	struct pgm_iovec vector[4];
+	for (unsigned i = 0; i < G_N_ELEMENTS(skbs); i++) {
+		skbs[i] = pgm_alloc_skb (100);
+		pgm_skb_put (skbs[i], 100);
+		vector[i].iov_base = skbs[i]->data;
+		vector[i].iov_len  = skbs[i]->len;
+	}
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	mock_errqueue_len = 0;
+	const size_t sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, skbs, G_N_ELEMENTS(skbs), (struct sockaddr*)&addr, sizeof(addr));
+	fail_unless (G_N_ELEMENTS(skbs) == sent, "sendmmsg underrun");
+	fail_unless (G_N_ELEMENTS(skbs) == sock->zc_len, "sends not held");
+	for (unsigned i = 0; i < G_N_ELEMENTS(skbs); i++)
+		fail_unless (2 == pgm_atomic_read32 (&skbs[i]->users), "skbuff not held");
+/* out of range */
+	mock_errqueue_push (10, 20);
+	pgm_zerocopy_reap (sock);
+	fail_unless (G_N_ELEMENTS(skbs) == sock->zc_len, "unsent identifiers released");
+/* out of order, head remains */
+	mock_errqueue_push (2, 3);
+	pgm_zerocopy_reap (sock);
+	fail_unless (G_N_ELEMENTS(skbs) == sock->zc_len, "ring head released out of order");
+	fail_unless (2 == pgm_atomic_read32 (&skbs[0]->users), "skbuff released early");
+	fail_unless (2 == pgm_atomic_read32 (&skbs[1]->users), "skbuff released early");
+	fail_unless (1 == pgm_atomic_read32 (&skbs[2]->users), "skbuff not released");
+	fail_unless (1 == pgm_atomic_read32 (&skbs[3]->users), "skbuff not released");
+/* coalesced, overlapping completed range */
+	mock_errqueue_push (0, 3);
+	pgm_zerocopy_reap (sock);
+	fail_unless (0 == sock->zc_len, "sends still held");
+	for (unsigned i = 0; i < G_N_ELEMENTS(skbs); i++) {
+		fail_unless (1 == pgm_atomic_read32 (&skbs[i]->users), "skbuff not released");
+		pgm_free_skb (skbs[i]);
+	}
+/* empty ring */
+	mock_errqueue_push (0, 3);
+	pgm_zerocopy_reap (sock);
+	fail_unless (1 == mock_errqueue_len, "error queue read without sends held");
+	mock_errqueue_len = 0;
+}
+END_TEST
+
+/* completion ring protected by a running sender */
+START_TEST (test_zerocopy_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	sock->use_zerocopy = TRUE;
+	sock->zc_ring = g_new0 (struct pgm_zc_slot_t, PGM_MAX_ZEROCOPY);
+	pgm_mutex_init (&sock->source_mutex);
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (100);
+	pgm_skb_put (skb, 100);
+	struct pgm_iovec vector[1] = { { .iov_base = skb->data, .iov_len = skb->len } };
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	mock_errqueue_len = 0;
+	const size_t sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, &skb, 1, (struct sockaddr*)&addr, sizeof(addr));
+	fail_unless (1 == sent, "sendmmsg underrun");
+	mock_errqueue_push (0, 0);
+	pgm_mutex_lock (&sock->source_mutex);
+	pgm_zerocopy_reap (sock);
+	pgm_mutex_unlock (&sock->source_mutex);
+	fail_unless (1 == sock->zc_len, "ring reaped without lock");
+	pgm_zerocopy_reap (sock);
+	fail_unless (0 == sock->zc_len, "send still held");
+	fail_unless (1 == pgm_atomic_read32 (&skb->users), "skbuff not released");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+/* repair waiting on a held skbuff re-signalled on release */
+START_TEST (test_zerocopy_pass_003)
+{
+	pgm_sock_t* sock = generate_sock ();
+	sock->use_zerocopy = TRUE;
+	sock->zc_ring = g_new0 (struct pgm_zc_slot_t, PGM_MAX_ZEROCOPY);
+	pgm_mutex_init (&sock->source_mutex);
+/* fcntl is mocked, set non-blocking to read without a signal */
+	const int one = 1;
+	pgm_notify_init (&sock->rdata_notify);
+	fail_unless (0 == ioctl (pgm_notify_get_socket (&sock->rdata_notify), FIONBIO, &one), "ioctl failed");
+	fail_unless (!pgm_notify_read (&sock->rdata_notify), "repair signalled");
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (100);
+	pgm_skb_put (skb, 100);
+	struct pgm_iovec vector[1] = { { .iov_base = skb->data, .iov_len = skb->len } };
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr ("239.192.0.1")
+	};
+	mock_errqueue_len = 0;
+	const size_t sent = pgm_sendmmsg (sock, FALSE, NULL, FALSE, vector, &skb, 1, (struct sockaddr*)&addr, sizeof(addr));
+	fail_unless (1 == sent, "sendmmsg underrun");
+	mock_is_retransmit_empty = FALSE;
+	mock_errqueue_push (0, 0);
+	pgm_zerocopy_reap (sock);
+	mock_is_retransmit_empty = TRUE;
+	fail_unless (0 == sock->zc_len, "send still held");
+	fail_unless (pgm_notify_read (&sock->rdata_notify), "repair not signalled");
+	pgm_notify_destroy (&sock->rdata_notify);
+	pgm_free_skb (skb);
+}
+END_TEST
+#endif /* USE_ZEROCOPY */
+
 /* target:
  * 	int
  * 	pgm_set_nonblocking (
@@ -392,6 +778,26 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_sendto, test_sendto_fail_005, SIGABRT);
 #endif
 
+	TCase* tc_sendto_hops = tcase_create ("sendto-hops");
+	suite_add_tcase (s, tc_sendto_hops);
+	tcase_add_test (tc_sendto_hops, test_sendto_hops_pass_001);
+
+	TCase* tc_sendmmsg = tcase_create ("sendmmsg");
+	suite_add_tcase (s, tc_sendmmsg);
+	tcase_add_test (tc_sendmmsg, test_sendmmsg_pass_001);
+#ifdef UDP_SEGMENT
+	tcase_add_test (tc_sendmmsg, test_sendmmsg_pass_002);
+	tcase_add_test (tc_sendmmsg, test_sendmmsg_pass_003);
+#endif
+
+#ifdef USE_ZEROCOPY
+	TCase* tc_zerocopy = tcase_create ("zerocopy");
+	suite_add_tcase (s, tc_zerocopy);
+	tcase_add_test (tc_zerocopy, test_zerocopy_pass_001);
+	tcase_add_test (tc_zerocopy, test_zerocopy_pass_002);
+	tcase_add_test (tc_zerocopy, test_zerocopy_pass_003);
+#endif
+
 	TCase* tc_set_nonblocking = tcase_create ("set-nonblocking");
 	suite_add_tcase (s, tc_set_nonblocking);
 	tcase_add_test (tc_set_nonblocking, test_set_nonblocking_pass_001);
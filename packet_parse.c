@@ -36,7 +36,7 @@
 
 /* locals */
 
-static bool pgm_parse (struct pgm_sk_buff_t*const restrict, pgm_error_t**restrict);
+static bool pgm_parse (struct pgm_sk_buff_t*const restrict, const bool, pgm_error_t**restrict);
 
 
 /* Parse a raw-IP packet for IP and PGM header and any payload.
@@ -232,13 +232,19 @@ pgm_parse_raw (
 /* advance DATA pointer to PGM packet */
 	skb->data	= skb->pgm_header;
 	skb->len       -= ip_header_length;
-	return pgm_parse (skb, error);
+	return pgm_parse (skb, FALSE, error);
 }
 
+/* Parse a UDP encapsulated or IPv6 PGM packet, with trust_checksum the
+ * transport checksum already validated by the kernel or NIC replaces the
+ * PGM checksum, which may then be absent from data packets.
+ */
+
 PGM_GNUC_INTERNAL
 bool
 pgm_parse_udp_encap (
 	struct pgm_sk_buff_t*const restrict skb,		/* will be modified */
+	const bool			    trust_checksum,
 	pgm_error_t**	      restrict error
 	)
 {
@@ -255,23 +261,38 @@ pgm_parse_udp_encap (
 
 /* DATA payload is PGM packet, no headers */
 	skb->pgm_header = skb->data;
-	return pgm_parse (skb, error);
+	return pgm_parse (skb, trust_checksum, error);
 }
 
-/* will modify packet contents to calculate and check PGM checksum
+/* will modify packet contents to calculate and check PGM checksum, the
+ * checksum of data packets is deferred to pgm_verify_checksum() after
+ * receive window admission.
  */
 static
 bool
 pgm_parse (
 	struct pgm_sk_buff_t*const restrict skb,		/* will be modified to calculate checksum */
+	const bool			    trust_checksum,
 	pgm_error_t**		    restrict error
 	)
 {
 /* pre-conditions */
 	pgm_assert (NULL != skb);
 
-/* pgm_checksum == 0 means no transmitted checksum */
-	if (skb->pgm_header->pgm_checksum)
+/* pgm_checksum == 0 means no transmitted checksum, a trusted transport
+ * checksum already covers the entire PGM packet.
+ */
+	if (trust_checksum)
+	{
+		pgm_debug ("Trusting transport checksum.");
+	}
+	else if (skb->pgm_header->pgm_checksum &&
+		 (PGM_ODATA == skb->pgm_header->pgm_type ||
+		  PGM_RDATA == skb->pgm_header->pgm_type))
+	{
+		pgm_debug ("Deferring PGM checksum to receive window admission.");
+	}
+	else if (skb->pgm_header->pgm_checksum)
 	{
 		const uint16_t sum = skb->pgm_header->pgm_checksum;
 		skb->pgm_header->pgm_checksum = 0;
@@ -305,6 +326,30 @@ pgm_parse (
 	return TRUE;
 }
 
+/* verify PGM checksum of a parsed packet, data and length may have been
+ * advanced past the PGM header but not truncated.
+ *
+ * returns TRUE on checksum match, returns FALSE on mismatch.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_verify_checksum (
+	struct pgm_sk_buff_t* const	skb		/* will be modified to calculate checksum */
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != skb);
+	pgm_assert (NULL != skb->pgm_header);
+
+	const uint16_t sum = skb->pgm_header->pgm_checksum;
+	const uint16_t pgm_len = (uint16_t)(((char*)skb->data + skb->len) - (char*)skb->pgm_header);
+	skb->pgm_header->pgm_checksum = 0;
+	const uint16_t pgm_sum = pgm_csum_fold (pgm_csum_partial ((const char*)skb->pgm_header, pgm_len, 0));
+	skb->pgm_header->pgm_checksum = sum;
+	return (pgm_sum == sum);
+}
+
 /* 8.1.  Source Path Messages (SPM)
  *
  *  0                   1                   2                   3
@@ -215,6 +215,7 @@ END_TEST
  *	bool
  *	pgm_parse_udp_encap (
  *		struct pgm_sk_buff_t* const	skb,
+ *		const bool			trust_checksum,
  *		pgm_error_t**			error
  *	)
  */
@@ -223,7 +224,7 @@ START_TEST (test_parse_udp_encap_pass_001)
 {
 	pgm_error_t* err = NULL;
 	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
-	gboolean success = pgm_parse_udp_encap (skb, &err);
+	gboolean success = pgm_parse_udp_encap (skb, FALSE, &err);
 	if (!success && err) {
 		g_error ("Parsing UDP encapsulated packet: %s", err->message);
 	}
@@ -231,10 +232,59 @@ START_TEST (test_parse_udp_encap_pass_001)
 }
 END_TEST
 
+/* ODATA without PGM checksum only valid when trusting the transport checksum */
+START_TEST (test_parse_udp_encap_pass_002)
+{
+	pgm_error_t* err = NULL;
+	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
+	struct pgm_header* pgmhdr = skb->data;
+	pgmhdr->pgm_checksum = 0;
+	fail_unless (FALSE == pgm_parse_udp_encap (skb, FALSE, &err), "parse_udp_encap failed");
+	fail_unless (NULL != err, "parse_udp_encap failed");
+	fail_unless (PGM_ERROR_PROTO == err->code, "parse_udp_encap failed");
+	pgm_error_free (err);
+	err = NULL;
+	skb = generate_udp_encap_pgm ();
+	pgmhdr = skb->data;
+	pgmhdr->pgm_checksum = 0;
+	fail_unless (TRUE == pgm_parse_udp_encap (skb, TRUE, &err), "parse_udp_encap failed");
+	fail_unless (NULL == err, "parse_udp_encap failed");
+}
+END_TEST
+
 START_TEST (test_parse_udp_encap_fail_001)
 {
 	pgm_error_t* err = NULL;
-	pgm_parse_udp_encap (NULL, &err);
+	pgm_parse_udp_encap (NULL, FALSE, &err);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_verify_checksum (
+ *		struct pgm_sk_buff_t* const	skb
+ *	)
+ */
+
+/* data packet checksum deferred by parser, verified with data advanced to payload */
+START_TEST (test_verify_checksum_pass_001)
+{
+	pgm_error_t* err = NULL;
+	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
+	struct pgm_data* datahdr = (gpointer)((struct pgm_header*)skb->data + 1);
+	datahdr->data_sqn = g_htonl (1);
+	fail_unless (TRUE == pgm_parse_udp_encap (skb, FALSE, &err), "parse_udp_encap failed");
+	pgm_skb_pull (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
+	fail_unless (FALSE == pgm_verify_checksum (skb), "verify_checksum failed");
+	datahdr->data_sqn = g_htonl (0);
+	fail_unless (TRUE == pgm_verify_checksum (skb), "verify_checksum failed");
+}
+END_TEST
+
+START_TEST (test_verify_checksum_fail_001)
+{
+	pgm_verify_checksum (NULL);
 	fail ("reached");
 }
 END_TEST
@@ -353,10 +403,18 @@ make_test_suite (void)
 	TCase* tc_parse_udp_encap = tcase_create ("parse-udp-encap");
 	suite_add_tcase (s, tc_parse_udp_encap);
 	tcase_add_test (tc_parse_udp_encap, test_parse_udp_encap_pass_001);
+	tcase_add_test (tc_parse_udp_encap, test_parse_udp_encap_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_parse_udp_encap, test_parse_udp_encap_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_verify_checksum = tcase_create ("verify-checksum");
+	suite_add_tcase (s, tc_verify_checksum);
+	tcase_add_test (tc_verify_checksum, test_verify_checksum_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_verify_checksum, test_verify_checksum_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_verify_spm = tcase_create ("verify-spm");
 	suite_add_tcase (s, tc_verify_spm);
 	tcase_add_test (tc_verify_spm, test_verify_spm_pass_001);
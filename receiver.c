@@ -310,6 +310,160 @@ pgm_peer_unref (
 	peer = NULL;
 }
 
+/* earliest pending timer of a peer: SPMR, ACK and NAK state queue tails, and
+ * the peer expiration itself.
+ */
+
+static
+pgm_time_t
+_pgm_peer_next_expiry (
+	const pgm_peer_t*	peer
+	)
+{
+	const pgm_rxw_t* window = peer->window;
+	pgm_time_t expiry = peer->expiry;
+
+	if (peer->spmr_expiry && pgm_time_after (expiry, peer->spmr_expiry))
+		expiry = peer->spmr_expiry;
+	if (window->ack_backoff_queue.tail && pgm_time_after (expiry, next_ack_rb_expiry (window)))
+		expiry = next_ack_rb_expiry (window);
+	if (window->nak_backoff_queue.tail && pgm_time_after (expiry, next_nak_rb_expiry (window)))
+		expiry = next_nak_rb_expiry (window);
+	if (window->wait_ncf_queue.tail && pgm_time_after (expiry, next_nak_rpt_expiry (window)))
+		expiry = next_nak_rpt_expiry (window);
+	if (window->wait_data_queue.tail && pgm_time_after (expiry, next_nak_rdata_expiry (window)))
+		expiry = next_nak_rdata_expiry (window);
+	return expiry;
+}
+
+/* peers are held in a binary min-heap keyed on next expiry so that timer
+ * dispatch only visits peers with expired timers.  the heap does not hold
+ * a reference, peers are removed before the final unref.
+ */
+
+static inline
+void
+_pgm_peer_heap_set (
+	pgm_sock_t*	sock,
+	pgm_peer_t*	peer,
+	const unsigned	index_
+	)
+{
+	sock->peers_heap[ index_ ] = peer;
+	peer->heap_index = index_;
+}
+
+static
+void
+_pgm_peer_heap_up (
+	pgm_sock_t*	sock,
+	unsigned	index_
+	)
+{
+	pgm_peer_t* peer = sock->peers_heap[ index_ ];
+
+	while (index_ > 0) {
+		const unsigned parent = (index_ - 1) / 2;
+		if (!pgm_time_after (sock->peers_heap[ parent ]->next_expiry, peer->next_expiry))
+			break;
+		_pgm_peer_heap_set (sock, sock->peers_heap[ parent ], index_);
+		index_ = parent;
+	}
+	_pgm_peer_heap_set (sock, peer, index_);
+}
+
+static
+void
+_pgm_peer_heap_down (
+	pgm_sock_t*	sock,
+	unsigned	index_
+	)
+{
+	pgm_peer_t* peer = sock->peers_heap[ index_ ];
+
+	for (;;) {
+		unsigned child = (2 * index_) + 1;
+		if (child >= sock->peers_heap_len)
+			break;
+		if (child + 1 < sock->peers_heap_len &&
+		    pgm_time_after (sock->peers_heap[ child ]->next_expiry, sock->peers_heap[ child + 1 ]->next_expiry))
+			child++;
+		if (!pgm_time_after (peer->next_expiry, sock->peers_heap[ child ]->next_expiry))
+			break;
+		_pgm_peer_heap_set (sock, sock->peers_heap[ child ], index_);
+		index_ = child;
+	}
+	_pgm_peer_heap_set (sock, peer, index_);
+}
+
+static
+void
+_pgm_peer_heap_insert (
+	pgm_sock_t*	sock,
+	pgm_peer_t*	peer
+	)
+{
+	if (sock->peers_heap_len == sock->peers_heap_size) {
+		sock->peers_heap_size = sock->peers_heap_size ? (2 * sock->peers_heap_size) : 16;
+		sock->peers_heap = pgm_realloc (sock->peers_heap, sock->peers_heap_size * sizeof(pgm_peer_t*));
+	}
+	peer->next_expiry = _pgm_peer_next_expiry (peer);
+	_pgm_peer_heap_set (sock, peer, sock->peers_heap_len++);
+	_pgm_peer_heap_up (sock, peer->heap_index);
+}
+
+static
+void
+_pgm_peer_heap_remove (
+	pgm_sock_t*	sock,
+	pgm_peer_t*	peer
+	)
+{
+	const unsigned index_ = peer->heap_index;
+	pgm_peer_t* last;
+
+	pgm_assert (index_ < sock->peers_heap_len);
+	pgm_assert (peer == sock->peers_heap[ index_ ]);
+
+	last = sock->peers_heap[ --sock->peers_heap_len ];
+	if (last == peer)
+		return;
+	_pgm_peer_heap_set (sock, last, index_);
+	if (pgm_time_after (peer->next_expiry, last->next_expiry))
+		_pgm_peer_heap_up (sock, index_);
+	else
+		_pgm_peer_heap_down (sock, index_);
+}
+
+/* re-key peer after receive window state changes, e.g. a new placeholder
+ * entering NAK back-off, or an SPM cancelling the SPMR timer.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_peer_update_expiry (
+	pgm_sock_t* const restrict	sock,
+	pgm_peer_t* const restrict	peer
+	)
+{
+	pgm_time_t next_expiry;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != peer);
+
+	next_expiry = _pgm_peer_next_expiry (peer);
+	if (next_expiry == peer->next_expiry)
+		return;
+	if (pgm_time_after (peer->next_expiry, next_expiry)) {
+		peer->next_expiry = next_expiry;
+		_pgm_peer_heap_up (sock, peer->heap_index);
+	} else {
+		peer->next_expiry = next_expiry;
+		_pgm_peer_heap_down (sock, peer->heap_index);
+	}
+}
+
 /* find PGM options in received SKB.
  *
  * returns TRUE if opt_fragment is found, otherwise FALSE is returned.
@@ -342,17 +496,26 @@ get_pgm_options (
 /* always at least two options, first is always opt_length */
 	do {
 		opt_header = (struct pgm_opt_header*)((char*)opt_header + opt_header->opt_length);
-/* option overflow */
-		if (PGM_UNLIKELY((char*)opt_header > (char*)skb->data))
+/* option overflow, data has been advanced to the end of the options */
+		if (PGM_UNLIKELY((char*)(opt_header + 1) > (char*)skb->data ||
+				 opt_header->opt_length < sizeof(struct pgm_opt_header) ||
+				 (char*)opt_header + opt_header->opt_length > (char*)skb->data))
 			break;
 
 		switch (opt_header->opt_type & PGM_OPT_MASK) {
 		case PGM_OPT_FRAGMENT:
+			if (PGM_UNLIKELY(opt_header->opt_length < sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_fragment)))
+				break;
 			skb->pgm_opt_fragment = (struct pgm_opt_fragment*)(opt_header + 1);
 			found_opt = TRUE;
 			break;
 
 		case PGM_OPT_PGMCC_DATA:
+			if (PGM_UNLIKELY(opt_header->opt_length < sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_pgmcc_data)))
+				break;
+			if (AFI_IP6 == ntohs (((struct pgm_opt_pgmcc_data*)(opt_header + 1))->opt_nla_afi) &&
+			    PGM_UNLIKELY(opt_header->opt_length < sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt6_pgmcc_data)))
+				break;
 			skb->pgm_opt_pgmcc_data = (struct pgm_opt_pgmcc_data*)(opt_header + 1);
 			found_opt = TRUE;
 			break;
@@ -416,6 +579,7 @@ pgm_new_peer (
 					sock->rxw_secs,
 					sock->rxw_max_rte,
 					sock->ack_c_p);
+	peer->window->skb_pool = sock->skb_pool;
 	peer->spmr_expiry = now + sock->spmr_expiry;
 
 /* add peer to hash table and linked list */
@@ -423,6 +587,7 @@ pgm_new_peer (
 	pgm_hashtable_insert (sock->peers_hashtable, &peer->tsi, _pgm_peer_ref (peer));
 	peer->peers_link.data = peer;
 	sock->peers_list = pgm_list_prepend_link (sock->peers_list, &peer->peers_link);
+	_pgm_peer_heap_insert (sock, peer);
 	pgm_rwlock_writer_unlock (&sock->peers_lock);
 
 	pgm_timer_lock (sock);
@@ -686,7 +851,7 @@ pgm_on_spm (
 				source->has_ondemand_parity  = opt_parity_prm->opt_reserved & PGM_PARITY_PRM_OND;
 				if (source->has_proactive_parity || source->has_ondemand_parity) {
 					source->is_fec_enabled = 1;
-					pgm_rxw_update_fec (source->window, parity_prm_tgs);
+					pgm_rxw_update_fec (source->window, parity_prm_tgs, opt_parity_prm->opt_reserved & PGM_PARITY_PRM_CAUCHY);
 				}
 			}
 		} while (!(opt_header->opt_type & PGM_OPT_END));
@@ -1731,16 +1896,13 @@ pgm_check_peer_state (
 	pgm_debug ("pgm_check_peer_state (sock:%p now:%" PGM_TIME_FORMAT ")",
 		(const void*)sock, now);
 
-	if (!sock->peers_list)
-		return TRUE;
-
-	for (pgm_list_t *it = sock->peers_list, *next = it->next;
-	     NULL != it;
-	     it = next)
+/* visit only peers with an expired timer, earliest first */
+	while (sock->peers_heap_len > 0)
 	{
-		pgm_peer_t* peer = it->data;
+		pgm_peer_t* peer = sock->peers_heap[ 0 ];
 
-		next = it->next;
+		if (pgm_time_after (peer->next_expiry, now))
+			break;
 
 		if (peer->spmr_expiry)
 		{
@@ -1804,12 +1966,19 @@ pgm_check_peer_state (
 				pgm_trace (PGM_LOG_ROLE_SESSION,_("Peer expired, tsi %s"), pgm_tsi_print (&peer->tsi));
 				pgm_hashtable_remove (sock->peers_hashtable, &peer->tsi);
 				sock->peers_list = pgm_list_remove_link (sock->peers_list, &peer->peers_link);
+				_pgm_peer_heap_remove (sock, peer);
 				if (sock->last_hash_value == peer)
 					sock->last_hash_value = NULL;
 				pgm_peer_unref (peer);
+				continue;
 			}
 		}
 
+/* timers left expired are retried on the next dispatch */
+		peer->next_expiry = _pgm_peer_next_expiry (peer);
+		if (!pgm_time_after (peer->next_expiry, now))
+			peer->next_expiry = now + 1;
+		_pgm_peer_heap_down (sock, 0);
 	}
 
 /* check for waiting contiguous packets */
@@ -1841,49 +2010,9 @@ pgm_min_receiver_expiry (
 	pgm_debug ("pgm_min_receiver_expiry (sock:%p expiration:%" PGM_TIME_FORMAT ")",
 		(void*)sock, expiration);
 
-	if (!sock->peers_list)
-		return expiration;
-
-	for (pgm_list_t *it = sock->peers_list, *next = it->next;
-	     NULL != it;
-	     it = next)
-	{
-		pgm_peer_t* peer = it->data;
-
-		next = it->next;
-
-		if (peer->spmr_expiry)
-		{
-			if (pgm_time_after_eq (expiration, peer->spmr_expiry))
-				expiration = peer->spmr_expiry;
-		}
-
-		if (peer->window->ack_backoff_queue.tail)
-		{
-			pgm_assert (sock->use_pgmcc);
-			if (pgm_time_after_eq (expiration, next_ack_rb_expiry (peer->window)))
-				expiration = next_ack_rb_expiry (peer->window);
-		}
-
-		if (peer->window->nak_backoff_queue.tail)
-		{
-			if (pgm_time_after_eq (expiration, next_nak_rb_expiry (peer->window)))
-				expiration = next_nak_rb_expiry (peer->window);
-		}
-
-		if (peer->window->wait_ncf_queue.tail)
-		{
-			if (pgm_time_after_eq (expiration, next_nak_rpt_expiry (peer->window)))
-				expiration = next_nak_rpt_expiry (peer->window);
-		}
-
-		if (peer->window->wait_data_queue.tail)
-		{
-			if (pgm_time_after_eq (expiration, next_nak_rdata_expiry (peer->window)))
-				expiration = next_nak_rdata_expiry (peer->window);
-		}
-
-	}
+	if (sock->peers_heap_len > 0 &&
+	    pgm_time_after (expiration, sock->peers_heap[ 0 ]->next_expiry))
+		expiration = sock->peers_heap[ 0 ]->next_expiry;
 
 	return expiration;
 }
@@ -2135,6 +2264,8 @@ nak_rdata_state (
  * OPT_FRAGMENT - this TPDU part of a larger APDU.
  *
  * Ownership of skb is taken and must be passed to the receive window or destroyed.
+ * Peer statistics and discards are accounted here as the checksum is verified
+ * only after receive window admission.
  *
  * returns TRUE is skb has been replaced, FALSE is remains unchanged and can be recycled.
  */
@@ -2161,12 +2292,25 @@ pgm_on_data (
 
 	const pgm_time_t nak_rb_expiry = skb->tstamp + nak_rb_ivl (sock);
 	const uint_fast16_t tsdu_length = ntohs (skb->pgm_header->pgm_tsdu_length);
+	const uint16_t tpdu_length = (uint16_t)(sizeof(struct pgm_header) + skb->len);
+	uint_fast16_t opt_total_length = 0;
 
 	skb->pgm_data = skb->data;
 
-	const uint_fast16_t opt_total_length = (skb->pgm_header->pgm_options & PGM_OPT_PRESENT) ?
-		ntohs(*(uint16_t*)( (char*)( skb->pgm_data + 1 ) + sizeof(uint16_t))) :
-		0;
+	if (PGM_UNLIKELY(skb->len < sizeof(struct pgm_data)))
+		goto malformed;
+	if (skb->pgm_header->pgm_options & PGM_OPT_PRESENT)
+	{
+		const struct pgm_opt_length* opt_len = (const struct pgm_opt_length*)(skb->pgm_data + 1);
+		if (PGM_UNLIKELY(skb->len < sizeof(struct pgm_data) + sizeof(struct pgm_opt_length) ||
+				 opt_len->opt_type != PGM_OPT_LENGTH ||
+				 opt_len->opt_length != sizeof(struct pgm_opt_length)))
+			goto malformed;
+		opt_total_length = ntohs (opt_len->opt_total_length);
+		if (PGM_UNLIKELY(opt_total_length < sizeof(struct pgm_opt_length) ||
+				 skb->len < sizeof(struct pgm_data) + opt_total_length))
+			goto malformed;
+	}
 
 /* advance data pointer to payload */
 	pgm_skb_pull (skb, (uint16_t)(sizeof(struct pgm_data) + opt_total_length));
@@ -2180,7 +2324,22 @@ pgm_on_data (
 		ack_rb_expiry = skb->tstamp + ack_rb_ivl (sock);
 	}
 
-	const int add_status = pgm_rxw_add (source->window, skb, skb->tstamp, nak_rb_expiry);
+/* packets certain to be discarded by the receive window skip payload checksum
+ * verification deferred from parsing, and as unverified are not accounted to
+ * the peer's bytes received or last packet time.
+ */
+	int add_status = pgm_rxw_admit (source->window, skb);
+	if (PGM_RXW_OK == add_status)
+	{
+		if (!sock->use_checksum_offload &&
+		    PGM_UNLIKELY(!pgm_verify_checksum (skb)))
+		{
+			goto cksum_error;
+		}
+		source->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED] += tpdu_length;
+		source->last_packet = skb->tstamp;
+		add_status = pgm_rxw_add (source->window, skb, skb->tstamp, nak_rb_expiry);
+	}
 
 /* skb reference is now invalid */
 	switch (add_status) {
@@ -2201,6 +2360,7 @@ pgm_on_data (
 /* fall through */
 	case PGM_RXW_BOUNDS:
 discarded:
+		source->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]++;
 		return FALSE;
 
 	default: pgm_assert_not_reached(); break;
@@ -2257,6 +2417,26 @@ discarded:
 		pgm_timer_unlock (sock);
 	}
 	return TRUE;
+
+/* a corrupt option header counts as a checksum error, not as malformed */
+malformed:
+	if (!sock->use_checksum_offload &&
+	    PGM_UNLIKELY(!pgm_verify_checksum (skb)))
+	{
+		goto cksum_error;
+	}
+	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed data packet."));
+	source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA]++;
+	goto discarded;
+
+/* inherently cannot determine PGM_PC_RECEIVER_CKSUM_ERRORS, the TSI is unverified */
+cksum_error:
+	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded data packet on PGM checksum mismatch."));
+	if (sock->can_send_data) {
+		sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS]++;
+		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+	}
+	return FALSE;
 }
 
 /* POLLs are generated by PGM Parents (Sources or Network Elements).
@@ -56,6 +56,7 @@
 #define pgm_verify_nak		mock_pgm_verify_nak
 #define pgm_verify_ncf		mock_pgm_verify_ncf
 #define pgm_verify_poll		mock_pgm_verify_poll
+#define pgm_verify_checksum	mock_pgm_verify_checksum
 #define pgm_sendto_hops		mock_pgm_sendto_hops
 #define pgm_time_now		mock_pgm_time_now
 #define pgm_time_update_now	mock_pgm_time_update_now
@@ -66,6 +67,7 @@
 #define pgm_rxw_confirm		mock_pgm_rxw_confirm
 #define pgm_rxw_lost		mock_pgm_rxw_lost
 #define pgm_rxw_state		mock_pgm_rxw_state
+#define pgm_rxw_admit		mock_pgm_rxw_admit
 #define pgm_rxw_add		mock_pgm_rxw_add
 #define pgm_rxw_remove_commit	mock_pgm_rxw_remove_commit
 #define pgm_rxw_readv		mock_pgm_rxw_readv
@@ -105,6 +107,29 @@ generate_peer (void)
 	return peer;
 }
 
+/* ODATA without payload, opt_total_length of zero omits options */
+static
+struct pgm_sk_buff_t*
+generate_odata (
+	const guint16		opt_total_length
+	)
+{
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (TEST_MAX_TPDU);
+	skb->pgm_header = skb->data;
+	pgm_skb_put (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
+	skb->pgm_header->pgm_type = PGM_ODATA;
+	if (opt_total_length > 0) {
+		struct pgm_opt_length* opt_len = skb->tail;
+		pgm_skb_put (skb, sizeof(struct pgm_opt_length));
+		opt_len->opt_type	  = PGM_OPT_LENGTH;
+		opt_len->opt_length	  = sizeof(struct pgm_opt_length);
+		opt_len->opt_total_length = g_htons (opt_total_length);
+		skb->pgm_header->pgm_options = PGM_OPT_PRESENT;
+	}
+	pgm_skb_pull (skb, sizeof(struct pgm_header));
+	return skb;
+}
+
 /** socket module */
 static
 int
@@ -210,6 +235,16 @@ mock_pgm_verify_poll (
 	return TRUE;
 }
 
+static bool mock_is_valid_checksum = TRUE;
+
+bool
+mock_pgm_verify_checksum (
+	struct pgm_sk_buff_t* const		skb
+	)
+{
+	return mock_is_valid_checksum;
+}
+
 /* receive window module */
 pgm_rxw_t*
 mock_pgm_rxw_create (
@@ -277,9 +312,19 @@ mock_pgm_rxw_update (
 void
 mock_pgm_rxw_update_fec (
 	pgm_rxw_t* const		window,
-	const uint8_t			rs_k
+	const uint8_t			rs_k,
+	const bool			rs_is_cauchy
+	)
+{
+}
+
+int
+mock_pgm_rxw_admit (
+	pgm_rxw_t* const		window,
+	struct pgm_sk_buff_t* const	skb
 	)
 {
+	return PGM_RXW_OK;
 }
 
 int
@@ -423,6 +468,29 @@ START_TEST (test_check_peer_state_pass_001)
 }
 END_TEST
 
+/* only peers with an expired timer are visited, postponed expiry re-keys the peer */
+START_TEST (test_check_peer_state_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->is_bound = TRUE;
+	sock->peer_expiry = TEST_PEER_EXPIRY;
+	pgm_peer_t* peer[3];
+	for (unsigned i = 0; i < G_N_ELEMENTS(peer); i++) {
+		peer[i] = generate_peer();
+		peer[i]->expiry = pgm_secs(i + 1);
+		peer[i]->pending_link.data = peer[i];
+		_pgm_peer_heap_insert (sock, peer[i]);
+	}
+	fail_unless (peer[0] == sock->peers_heap[0], "heap order");
+	fail_unless (TRUE == pgm_check_peer_state (sock, pgm_secs(2)), "check_peer_state failed");
+	fail_unless (3 == sock->peers_heap_len, "peer removed");
+	fail_unless (pgm_secs(1) + TEST_PEER_EXPIRY == peer[0]->expiry, "peer[0] not postponed");
+	fail_unless (pgm_secs(2) + TEST_PEER_EXPIRY == peer[1]->expiry, "peer[1] not postponed");
+	fail_unless (pgm_secs(3) == peer[2]->expiry, "peer[2] visited");
+	fail_unless (peer[2] == sock->peers_heap[0], "heap order");
+}
+END_TEST
+
 START_TEST (test_check_peer_state_fail_001)
 {
 	pgm_check_peer_state (NULL, mock_pgm_time_now);
@@ -447,6 +515,27 @@ START_TEST (test_min_receiver_expiry_pass_001)
 }
 END_TEST
 
+START_TEST (test_min_receiver_expiry_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->is_bound = TRUE;
+	pgm_peer_t* peer[3];
+	for (unsigned i = 0; i < G_N_ELEMENTS(peer); i++) {
+		peer[i] = generate_peer();
+		peer[i]->expiry = pgm_secs(3 - i);
+		_pgm_peer_heap_insert (sock, peer[i]);
+	}
+	fail_unless (pgm_secs(1) == pgm_min_receiver_expiry (sock, pgm_secs(10)), "min_receiver_expiry failed");
+	fail_unless (pgm_msecs(500) == pgm_min_receiver_expiry (sock, pgm_msecs(500)), "min_receiver_expiry failed");
+/* timer brought forward */
+	peer[0]->spmr_expiry = pgm_msecs(250);
+	pgm_peer_update_expiry (sock, peer[0]);
+	fail_unless (pgm_msecs(250) == pgm_min_receiver_expiry (sock, pgm_secs(10)), "min_receiver_expiry failed");
+	_pgm_peer_heap_remove (sock, peer[0]);
+	fail_unless (pgm_secs(1) == pgm_min_receiver_expiry (sock, pgm_secs(10)), "min_receiver_expiry failed");
+}
+END_TEST
+
 START_TEST (test_min_receiver_expiry_fail_001)
 {
 	const pgm_time_t expiration = pgm_secs(1);
@@ -455,6 +544,61 @@ START_TEST (test_min_receiver_expiry_fail_001)
 }
 END_TEST
 
+/* target:
+ *	bool
+ *	pgm_on_data (
+ *		pgm_sock_t* const		sock,
+ *		pgm_peer_t* const		source,
+ *		struct pgm_sk_buff_t* const	skb
+ *		)
+ */
+
+/* checksum mismatch is a source discard, peer statistics are untouched */
+START_TEST (test_on_data_pass_001)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->can_send_data = TRUE;
+	sock->nak_bo_ivl = TEST_NAK_BO_IVL;
+	pgm_peer_t* peer = generate_peer();
+	struct pgm_sk_buff_t* skb = generate_odata (0);
+	skb->tstamp = pgm_secs(1);
+	mock_is_valid_checksum = FALSE;
+	fail_unless (FALSE == pgm_on_data (sock, peer, skb), "on_data failed");
+	fail_unless (1 == sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS], "checksum error not counted");
+	fail_unless (1 == sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED], "source discard not counted");
+	fail_unless (0 == peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED], "receiver discard counted");
+	fail_unless (0 == peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED], "bytes received counted");
+	fail_unless (0 == peer->last_packet, "last packet updated");
+	mock_is_valid_checksum = TRUE;
+	skb = generate_odata (0);
+	skb->tstamp = pgm_secs(1);
+	fail_unless (TRUE == pgm_on_data (sock, peer, skb), "on_data failed");
+	fail_unless (sizeof(struct pgm_header) + sizeof(struct pgm_data) == peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED], "bytes received not counted");
+	fail_unless (pgm_secs(1) == peer->last_packet, "last packet not updated");
+}
+END_TEST
+
+/* option length past packet end */
+START_TEST (test_on_data_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->nak_bo_ivl = TEST_NAK_BO_IVL;
+	pgm_peer_t* peer = generate_peer();
+	struct pgm_sk_buff_t* skb = generate_odata (0xffff);
+	fail_unless (FALSE == pgm_on_data (sock, peer, skb), "on_data failed");
+	fail_unless (1 == peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA], "malformed not counted");
+	fail_unless (1 == peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED], "receiver discard not counted");
+	fail_unless (0 == peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED], "bytes received counted");
+}
+END_TEST
+
+START_TEST (test_on_data_fail_001)
+{
+	pgm_on_data (NULL, NULL, NULL);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	bool
  *	pgm_setsockopt (
@@ -823,6 +967,7 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_check_peer_state);
 	tcase_add_checked_fixture (tc_check_peer_state, mock_setup, NULL);
 	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_001);
+	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_check_peer_state, test_check_peer_state_fail_001, SIGABRT);
 #endif
@@ -832,10 +977,20 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_min_receiver_expiry);
 	tcase_add_checked_fixture (tc_min_receiver_expiry, mock_setup, NULL);
 	tcase_add_test (tc_min_receiver_expiry, test_min_receiver_expiry_pass_001);
+	tcase_add_test (tc_min_receiver_expiry, test_min_receiver_expiry_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_min_receiver_expiry, test_min_receiver_expiry_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_on_data = tcase_create ("on-data");
+	suite_add_tcase (s, tc_on_data);
+	tcase_add_checked_fixture (tc_on_data, mock_setup, NULL);
+	tcase_add_test (tc_on_data, test_on_data_pass_001);
+	tcase_add_test (tc_on_data, test_on_data_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_on_data, test_on_data_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_set_rxw_sqns = tcase_create ("set-rxw_sqns");
 	suite_add_tcase (s, tc_set_rxw_sqns);
 	tcase_add_checked_fixture (tc_set_rxw_sqns, mock_setup, NULL);
@@ -32,6 +32,7 @@
 #	include <sys/types.h>
 #	include <sys/socket.h>
 #	include <netinet/in.h>		/* _GNU_SOURCE for in6_pktinfo */
+#	include <netinet/udp.h>		/* UDP_GRO */
 #else
 #	include <ws2tcpip.h>
 #	include <mswsock.h>
@@ -42,6 +43,7 @@
 #include <impl/packet_parse.h>
 #include <impl/timer.h>
 #include <impl/engine.h>
+#include <impl/uring.h>
 
 
 //#define RECV_DEBUG
@@ -51,12 +53,14 @@
 #endif
 
 #ifndef _WIN32
+#	define pgm_msghdr			msghdr
 #	define PGM_CMSG_FIRSTHDR(msg)		CMSG_FIRSTHDR(msg)
 #	define PGM_CMSG_NXTHDR(msg, cmsg)	CMSG_NXTHDR(msg, cmsg)
 #	define PGM_CMSG_DATA(cmsg)		CMSG_DATA(cmsg)
 #	define PGM_CMSG_SPACE(len)		CMSG_SPACE(len)
 #	define PGM_CMSG_LEN(len)		CMSG_LEN(len)
 #else
+#	define pgm_msghdr			_WSAMSG
 #	define PGM_CMSG_FIRSTHDR(msg)		WSA_CMSG_FIRSTHDR(msg)
 #	define PGM_CMSG_NXTHDR(msg, cmsg)	WSA_CMSG_NXTHDR(msg, cmsg)
 #	define PGM_CMSG_DATA(cmsg)		WSA_CMSG_DATA(cmsg)
@@ -76,6 +80,123 @@
 #endif
 
 
+#ifdef SO_TIMESTAMPNS
+/* kernel receive time stamp of a packet from ancillary data, saving a clock
+ * read per packet and excluding time queued on the socket.
+ *
+ * returns TRUE on success, returns FALSE when no time stamp is present.
+ */
+
+static
+bool
+recvskb_tstamp (
+	struct msghdr* const restrict msg,
+	pgm_time_t*    const restrict tstamp
+	)
+{
+	struct cmsghdr* cmsg;
+	for (cmsg = CMSG_FIRSTHDR(msg);
+	     cmsg != NULL;
+	     cmsg = CMSG_NXTHDR(msg, cmsg))
+	{
+		if (SOL_SOCKET == cmsg->cmsg_level &&
+		    SCM_TIMESTAMPNS == cmsg->cmsg_type)
+		{
+			struct timespec ts;
+			memcpy (&ts, CMSG_DATA(cmsg), sizeof(ts));
+			*tstamp = pgm_time_from_wallclock (pgm_secs (ts.tv_sec) + ts.tv_nsec / 1000);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+#endif /* SO_TIMESTAMPNS */
+
+/* destination address of a packet from ancillary data.
+ *
+ * returns TRUE on success, returns FALSE on invalid address.
+ */
+
+static
+bool
+recvskb_dst_addr (
+	struct pgm_msghdr* const restrict msg,
+	struct sockaddr*   const restrict dst_addr
+	)
+{
+	struct pgm_cmsghdr* cmsg;
+	for (cmsg = PGM_CMSG_FIRSTHDR(msg);
+	     cmsg != NULL;
+	     cmsg = PGM_CMSG_NXTHDR(msg, cmsg))
+	{
+/* both IP_PKTINFO and IP_RECVDSTADDR exist on OpenSolaris, so capture
+ * each type if defined.
+ */
+#ifdef IP_PKTINFO
+		if (IPPROTO_IP == cmsg->cmsg_level && 
+		    IP_PKTINFO == cmsg->cmsg_type)
+		{
+			const void* pktinfo		= PGM_CMSG_DATA(cmsg);
+/* discard on invalid address */
+			if (PGM_UNLIKELY(NULL == pktinfo)) {
+				pgm_debug ("in_pktinfo is NULL");
+				return FALSE;
+			}
+			const struct in_pktinfo* in	= pktinfo;
+			struct sockaddr_in s4;
+			memset (&s4, 0, sizeof(s4));
+			s4.sin_family			= AF_INET;
+			s4.sin_addr.s_addr		= in->ipi_addr.s_addr;
+			memcpy (dst_addr, &s4, sizeof(s4));
+			break;
+		}
+#endif
+#ifdef IP_RECVDSTADDR
+		if (IPPROTO_IP == cmsg->cmsg_level &&
+		    IP_RECVDSTADDR == cmsg->cmsg_type)
+		{
+			const void* recvdstaddr		= PGM_CMSG_DATA(cmsg);
+/* discard on invalid address */
+			if (PGM_UNLIKELY(NULL == recvdstaddr)) {
+				pgm_debug ("in_recvdstaddr is NULL");
+				return FALSE;
+			}
+			const struct in_addr* in	= recvdstaddr;
+			struct sockaddr_in s4;
+			memset (&s4, 0, sizeof(s4));
+			s4.sin_family			= AF_INET;
+			s4.sin_addr.s_addr		= in->s_addr;
+			memcpy (dst_addr, &s4, sizeof(s4));
+			break;
+		}
+#endif
+#if !defined(IP_PKTINFO) && !defined(IP_RECVDSTADDR)
+#	error "No defined CMSG type for IPv4 destination address."
+#endif
+
+		if (IPPROTO_IPV6 == cmsg->cmsg_level && 
+		    IPV6_PKTINFO == cmsg->cmsg_type)
+		{
+			const void* pktinfo		= PGM_CMSG_DATA(cmsg);
+/* discard on invalid address */
+			if (PGM_UNLIKELY(NULL == pktinfo)) {
+				pgm_debug ("in6_pktinfo is NULL");
+				return FALSE;
+			}
+			const struct in6_pktinfo* in6	= pktinfo;
+			struct sockaddr_in6 s6;
+			memset (&s6, 0, sizeof(s6));
+			s6.sin6_family			= AF_INET6;
+			s6.sin6_addr			= in6->ipi6_addr;
+			s6.sin6_scope_id		= in6->ipi6_ifindex;
+			memcpy (dst_addr, &s6, sizeof(s6));
+/* does not set flow id */
+			break;
+		}
+	}
+	return TRUE;
+}
+
 /* read a packet into a PGM skbuff
  * on success returns packet length, on closed socket returns 0,
  * on error returns -1.
@@ -153,88 +274,410 @@ recvskb (
 #endif
 
 	skb->sock		= sock;
+#ifdef SO_TIMESTAMPNS
+	if (!sock->use_kernel_tstamp || !recvskb_tstamp (&msg, &skb->tstamp))
+		skb->tstamp	= pgm_time_update_now();
+#else
 	skb->tstamp		= pgm_time_update_now();
+#endif
 	skb->data		= skb->head;
 	skb->len		= (uint16_t)len;
 	skb->zero_padded	= 0;
 	skb->tail		= (char*)skb->data + len;
 
-	if (sock->udp_encap_ucast_port ||
-	    AF_INET6 == pgm_sockaddr_family (src_addr))
+	if ((sock->udp_encap_ucast_port ||
+	     AF_INET6 == pgm_sockaddr_family (src_addr)) &&
+	    !recvskb_dst_addr (&msg, dst_addr))
+	{
+		return -1;
+	}
+	return len;
+}
+
+#ifdef HAVE_RECVMMSG
+/* read a batch of packets into the receive ring with one system call.
+ * on success returns count of packets read, on closed socket returns 0,
+ * on error returns -1.
+ */
+
+static
+ssize_t
+recvmmskb (
+	pgm_sock_t* const	sock,
+	const int		flags
+	)
+{
+	struct mmsghdr	 msgs[ PGM_MAX_RECV_BATCH ];
+	struct pgm_iovec iov[ PGM_MAX_RECV_BATCH ];
+	const unsigned	 count = sock->rx_ring_size;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock->rx_ring);
+	pgm_assert (count <= PGM_MAX_RECV_BATCH);
+
+	if (PGM_UNLIKELY(sock->is_destroyed))
+		return 0;
+
+	memset (msgs, 0, count * sizeof(struct mmsghdr));
+	for (unsigned i = 0; i < count; i++)
+	{
+		struct pgm_rx_slot_t* slot	= &sock->rx_ring[ i ];
+		iov[ i ].iov_base		= slot->skb->head;
+		iov[ i ].iov_len		= sock->max_tpdu;
+		msgs[ i ].msg_hdr.msg_name	= &slot->src_addr;
+		msgs[ i ].msg_hdr.msg_namelen	= sizeof(slot->src_addr);
+		msgs[ i ].msg_hdr.msg_iov	= (void*)&iov[ i ];
+		msgs[ i ].msg_hdr.msg_iovlen	= 1;
+		msgs[ i ].msg_hdr.msg_control	= slot->aux;
+		msgs[ i ].msg_hdr.msg_controllen= sizeof(slot->aux);
+	}
+
+	const int n = recvmmsg (sock->recv_sock, msgs, count, flags, NULL);
+	pgm_debug ("recvmmsg returned %d", n);
+	if (n <= 0)
+		return n;
+
+/* one timestamp for the batch */
+	const pgm_time_t now = pgm_time_update_now();
+	for (unsigned i = 0; i < (unsigned)n; i++)
 	{
-		struct pgm_cmsghdr* cmsg;
-		for (cmsg = PGM_CMSG_FIRSTHDR(&msg);
-		     cmsg != NULL;
-		     cmsg = PGM_CMSG_NXTHDR(&msg, cmsg))
+		struct pgm_rx_slot_t* slot	= &sock->rx_ring[ i ];
+		struct pgm_sk_buff_t* skb	= slot->skb;
+		const size_t len		= msgs[ i ].msg_len;
+
+		skb->sock		= sock;
+#	ifdef SO_TIMESTAMPNS
+		if (!sock->use_kernel_tstamp || !recvskb_tstamp (&msgs[ i ].msg_hdr, &skb->tstamp))
+			skb->tstamp	= now;
+#	else
+		skb->tstamp		= now;
+#	endif
+		skb->data		= skb->head;
+		skb->len		= (uint16_t)len;
+		skb->zero_padded	= 0;
+		skb->tail		= (char*)skb->data + len;
+		slot->len		= (ssize_t)len;
+
+		if ((sock->udp_encap_ucast_port ||
+		     AF_INET6 == slot->src_addr.ss_family) &&
+		    !recvskb_dst_addr (&msgs[ i ].msg_hdr, (struct sockaddr*)&slot->dst_addr))
 		{
-/* both IP_PKTINFO and IP_RECVDSTADDR exist on OpenSolaris, so capture
- * each type if defined.
+			pgm_debug ("Discarded packet with invalid destination address.");
+			slot->len = -1;
+		}
+	}
+	sock->rx_ring_len	= n;
+	sock->rx_ring_offset	= 0;
+	return n;
+}
+
+#	ifdef UDP_GRO
+/* read one UDP generic receive offload buffer scattered across the receive
+ * ring, one expected TPDU per ring skbuff.  segments of any other size are
+ * re-split through sock::rx_gro_buffer.
+ *
+ * on success returns count of packets read, on closed socket returns 0,
+ * on error returns -1.
  */
-#ifdef IP_PKTINFO
-			if (IPPROTO_IP == cmsg->cmsg_level && 
-			    IP_PKTINFO == cmsg->cmsg_type)
-			{
-				const void* pktinfo		= PGM_CMSG_DATA(cmsg);
-/* discard on invalid address */
-				if (PGM_UNLIKELY(NULL == pktinfo)) {
-					pgm_debug ("in_pktinfo is NULL");
-					return -1;
-				}
-				const struct in_pktinfo* in	= pktinfo;
-				struct sockaddr_in s4;
-				memset (&s4, 0, sizeof(s4));
-				s4.sin_family			= AF_INET;
-				s4.sin_addr.s_addr		= in->ipi_addr.s_addr;
-				memcpy (dst_addr, &s4, sizeof(s4));
-				break;
-			}
-#endif
-#ifdef IP_RECVDSTADDR
-			if (IPPROTO_IP == cmsg->cmsg_level &&
-			    IP_RECVDSTADDR == cmsg->cmsg_type)
-			{
-				const void* recvdstaddr		= PGM_CMSG_DATA(cmsg);
-/* discard on invalid address */
-				if (PGM_UNLIKELY(NULL == recvdstaddr)) {
-					pgm_debug ("in_recvdstaddr is NULL");
-					return -1;
-				}
-				const struct in_addr* in	= recvdstaddr;
-				struct sockaddr_in s4;
-				memset (&s4, 0, sizeof(s4));
-				s4.sin_family			= AF_INET;
-				s4.sin_addr.s_addr		= in->s_addr;
-				memcpy (dst_addr, &s4, sizeof(s4));
-				break;
-			}
-#endif
-#if !defined(IP_PKTINFO) && !defined(IP_RECVDSTADDR)
-#	error "No defined CMSG type for IPv4 destination address."
-#endif
 
-			if (IPPROTO_IPV6 == cmsg->cmsg_level && 
-			    IPV6_PKTINFO == cmsg->cmsg_type)
-			{
-				const void* pktinfo		= PGM_CMSG_DATA(cmsg);
-/* discard on invalid address */
-				if (PGM_UNLIKELY(NULL == pktinfo)) {
-					pgm_debug ("in6_pktinfo is NULL");
-					return -1;
-				}
-				const struct in6_pktinfo* in6	= pktinfo;
-				struct sockaddr_in6 s6;
-				memset (&s6, 0, sizeof(s6));
-				s6.sin6_family			= AF_INET6;
-				s6.sin6_addr			= in6->ipi6_addr;
-				s6.sin6_scope_id		= in6->ipi6_ifindex;
-				memcpy (dst_addr, &s6, sizeof(s6));
-/* does not set flow id */
-				break;
+static
+ssize_t
+recvskb_gro (
+	pgm_sock_t* const	sock,
+	const int		flags
+	)
+{
+	struct pgm_iovec	iov[ PGM_MAX_RECV_BATCH ];
+	struct pgm_rx_slot_t*	head = &sock->rx_ring[ 0 ];
+	const size_t		tpdu_length = sock->max_tpdu - sock->iphdr_len;
+	const unsigned		count = sock->rx_ring_size;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock->rx_ring);
+	pgm_assert (NULL != sock->rx_gro_buffer);
+	pgm_assert (count <= PGM_MAX_RECV_BATCH);
+
+	if (PGM_UNLIKELY(sock->is_destroyed))
+		return 0;
+
+	for (unsigned i = 0; i < count; i++) {
+		iov[ i ].iov_base	= sock->rx_ring[ i ].skb->head;
+		iov[ i ].iov_len	= tpdu_length;
+	}
+	struct msghdr msg = {
+		.msg_name	= &head->src_addr,
+		.msg_namelen	= sizeof(head->src_addr),
+		.msg_iov	= (void*)iov,
+		.msg_iovlen	= count,
+		.msg_control	= head->aux,
+		.msg_controllen = sizeof(head->aux),
+		.msg_flags	= 0
+	};
+	const ssize_t len = recvmsg (sock->recv_sock, &msg, flags);
+	if (len <= 0)
+		return len;
+
+/* segment size is only present on coalesced buffers */
+	size_t gso_size = (size_t)len;
+	struct cmsghdr* cmsg;
+	for (cmsg = CMSG_FIRSTHDR(&msg);
+	     cmsg != NULL;
+	     cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if (SOL_UDP == cmsg->cmsg_level &&
+		    UDP_GRO == cmsg->cmsg_type)
+		{
+			int segment_size;
+			memcpy (&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+			gso_size = (size_t)segment_size;
+			break;
+		}
+	}
+	pgm_debug ("recvmsg returned %" PRIzd " bytes in %" PRIzu " byte segments", len, gso_size);
+
+	sock->rx_ring_len	= 1;
+	sock->rx_ring_offset	= 0;
+	if (PGM_UNLIKELY(0 == gso_size ||
+			 gso_size > tpdu_length ||
+			 ((size_t)len + gso_size - 1) / gso_size > count ||
+			 (msg.msg_flags & MSG_TRUNC)))
+	{
+		pgm_debug ("Discarded truncated coalesced buffer.");
+		head->len = -1;
+		return 1;
+	}
+	if (PGM_UNLIKELY(!recvskb_dst_addr (&msg, (struct sockaddr*)&head->dst_addr))) {
+		pgm_debug ("Discarded packet with invalid destination address.");
+		head->len = -1;
+		return 1;
+	}
+
+	const unsigned n = (unsigned)(((size_t)len + gso_size - 1) / gso_size);
+
+/* segments not aligned to the ring skbuffs are gathered and copied out */
+	if (n > 1 && gso_size != tpdu_length)
+	{
+		size_t offset = 0;
+		for (unsigned i = 0; offset < (size_t)len; i++) {
+			const size_t chunk = MIN(tpdu_length, (size_t)len - offset);
+			memcpy (sock->rx_gro_buffer + offset, iov[ i ].iov_base, chunk);
+			offset += chunk;
+		}
+		for (unsigned i = 0; i < n; i++) {
+			offset = i * gso_size;
+			memcpy (sock->rx_ring[ i ].skb->head, sock->rx_gro_buffer + offset, MIN(gso_size, (size_t)len - offset));
+		}
+	}
+
+/* one timestamp for the buffer */
+	pgm_time_t now;
+#		ifdef SO_TIMESTAMPNS
+	if (!sock->use_kernel_tstamp || !recvskb_tstamp (&msg, &now))
+		now = pgm_time_update_now();
+#		else
+	now = pgm_time_update_now();
+#		endif
+	for (unsigned i = 0; i < n; i++)
+	{
+		struct pgm_rx_slot_t* slot	= &sock->rx_ring[ i ];
+		struct pgm_sk_buff_t* skb	= slot->skb;
+		const size_t seglen		= MIN(gso_size, (size_t)len - (i * gso_size));
+
+		skb->sock		= sock;
+		skb->tstamp		= now;
+		skb->data		= skb->head;
+		skb->len		= (uint16_t)seglen;
+		skb->zero_padded	= 0;
+		skb->tail		= (char*)skb->data + seglen;
+		slot->len		= (ssize_t)seglen;
+		if (i > 0) {
+			memcpy (&slot->src_addr, &head->src_addr, sizeof(head->src_addr));
+			memcpy (&slot->dst_addr, &head->dst_addr, sizeof(head->dst_addr));
+		}
+	}
+	sock->rx_ring_len	= n;
+	return n;
+}
+#	endif /* UDP_GRO */
+
+#	ifdef HAVE_LINUX_IO_URING_H
+/* queue a receive request for a ring slot.  the submission queue holds at
+ * least rx_ring_size entries and each slot owns at most one request, so a
+ * full queue is not expected, a slot that cannot be queued is kept on the
+ * re-arm list for the next read rather than left without a request.
+ */
+
+static inline
+void
+recvskb_uring_arm (
+	pgm_sock_t* const	sock,
+	const unsigned		index
+	)
+{
+	if (PGM_UNLIKELY(!pgm_uring_recv_slot (sock->rx_uring, sock->recv_sock, &sock->rx_ring[ index ], index, sock->max_tpdu))) {
+		pgm_debug ("io_uring submission queue full, re-arming slot %u on next read.", index);
+		sock->rx_uring_rearm[ sock->rx_uring_rearm_len++ ] = index;
+	}
+}
+
+/* re-arm the receive requests of the demuxed batch, submit them with one
+ * system call, and collect completed requests into the receive ring in
+ * completion order.
+ *
+ * on success returns count of packets read, on closed socket returns 0,
+ * on error returns -1.
+ */
+
+static
+ssize_t
+recvskb_uring (
+	pgm_sock_t* const	sock
+	)
+{
+	unsigned n = 0, index;
+	int res, save_errno = EAGAIN;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock->rx_ring);
+	pgm_assert (NULL != sock->rx_uring);
+
+	if (PGM_UNLIKELY(sock->is_destroyed))
+		return 0;
+
+/* slots left over from a full submission queue first, re-queueing in place */
+	const unsigned rearm_len = sock->rx_uring_rearm_len;
+	sock->rx_uring_rearm_len = 0;
+	for (unsigned i = 0; i < rearm_len; i++)
+		recvskb_uring_arm (sock, sock->rx_uring_rearm[ i ]);
+	for (unsigned i = 0; i < sock->rx_ring_len; i++)
+		recvskb_uring_arm (sock, sock->rx_uring_order[ i ]);
+	sock->rx_ring_len	= 0;
+	sock->rx_ring_offset	= 0;
+	if (PGM_UNLIKELY(-1 == pgm_uring_submit (sock->rx_uring)))
+		return -1;
+
+/* one timestamp for the batch */
+	const pgm_time_t now = pgm_time_update_now();
+	while (n < sock->rx_ring_size &&
+	       pgm_uring_reap (sock->rx_uring, &index, &res))
+	{
+		struct pgm_rx_slot_t* slot	= &sock->rx_ring[ index ];
+		if (PGM_UNLIKELY(res < 0)) {
+			pgm_debug ("io_uring recvmsg returned errno=%i", -res);
+			save_errno = -res;
+			recvskb_uring_arm (sock, index);
+			continue;
+		}
+
+		struct pgm_sk_buff_t* skb	= slot->skb;
+		const size_t len		= (size_t)res;
+
+		skb->sock		= sock;
+#		ifdef SO_TIMESTAMPNS
+		if (!sock->use_kernel_tstamp || !recvskb_tstamp (&slot->msg, &skb->tstamp))
+			skb->tstamp	= now;
+#		else
+		skb->tstamp		= now;
+#		endif
+		skb->data		= skb->head;
+		skb->len		= (uint16_t)len;
+		skb->zero_padded	= 0;
+		skb->tail		= (char*)skb->data + len;
+		slot->len		= (ssize_t)len;
+
+		if ((sock->udp_encap_ucast_port ||
+		     AF_INET6 == slot->src_addr.ss_family) &&
+		    !recvskb_dst_addr (&slot->msg, (struct sockaddr*)&slot->dst_addr))
+		{
+			pgm_debug ("Discarded packet with invalid destination address.");
+			slot->len = -1;
+		}
+		sock->rx_uring_order[ n++ ] = index;
+	}
+	if (0 == n) {
+/* failed requests are re-armed on the next read */
+		pgm_uring_submit (sock->rx_uring);
+		errno = save_errno;
+		return -1;
+	}
+	sock->rx_ring_len	= n;
+	return n;
+}
+#	endif /* HAVE_LINUX_IO_URING_H */
+
+/* take the next packet from the receive ring, refilling the ring with one
+ * batched read when exhausted.  the packet skbuff is swapped with
+ * sock::rx_buffer so that the demux path is unchanged.
+ *
+ * on success returns packet length, on closed socket returns 0,
+ * on error returns -1.
+ */
+
+static
+ssize_t
+recvskb_ring (
+	pgm_sock_t*	 const restrict sock,
+	struct sockaddr* const restrict src_addr,
+	const socklen_t			src_addrlen,
+	struct sockaddr* const restrict dst_addr,
+	const socklen_t			dst_addrlen
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != src_addr);
+	pgm_assert (src_addrlen > 0);
+	pgm_assert (NULL != dst_addr);
+	pgm_assert (dst_addrlen > 0);
+
+	for (;;)
+	{
+		if (sock->rx_ring_offset == sock->rx_ring_len) {
+			ssize_t n;
+#	ifdef HAVE_LINUX_IO_URING_H
+			if (sock->rx_uring)
+				n = recvskb_uring (sock);
+			else
+#	endif
+#	ifdef UDP_GRO
+			if (sock->use_udp_gro)
+				n = recvskb_gro (sock, 0);
+			else
+#	endif
+				n = recvmmskb (sock, 0);
+			if (n <= 0)
+				return n;
+		}
+
+		unsigned index = sock->rx_ring_offset++;
+#	ifdef HAVE_LINUX_IO_URING_H
+		if (sock->rx_uring)
+			index = sock->rx_uring_order[ index ];
+#	endif
+		struct pgm_rx_slot_t* slot = &sock->rx_ring[ index ];
+		if (PGM_UNLIKELY(slot->len < 0))
+			continue;
+
+#	ifdef PGM_DEBUG
+/* drop and take the next slot, the socket may not signal the remainder */
+		if (PGM_UNLIKELY(pgm_loss_rate > 0)) {
+			const unsigned percent = pgm_rand_int_range (&sock->rand_, 0, 100);
+			if (percent <= pgm_loss_rate) {
+				pgm_debug ("Simulated packet loss");
+				continue;
 			}
 		}
+#	endif
+
+		struct pgm_sk_buff_t* skb = sock->rx_buffer;
+		sock->rx_buffer = slot->skb;
+		slot->skb = skb;
+		memcpy (src_addr, &slot->src_addr, MIN(src_addrlen, sizeof(slot->src_addr)));
+		memcpy (dst_addr, &slot->dst_addr, MIN(dst_addrlen, sizeof(slot->dst_addr)));
+		return slot->len;
 	}
-	return len;
 }
+#endif /* HAVE_RECVMMSG */
 
 /* upstream = receiver to source, peer-to-peer = receive to receiver
  *
@@ -436,17 +879,30 @@ on_downstream (
 	}
 
 /* search for TSI peer context or create a new one */
-	if (PGM_LIKELY(pgm_tsi_hash (&skb->tsi) == sock->last_hash_key &&
-			NULL != sock->last_hash_value))
+	if (PGM_LIKELY(NULL != sock->last_hash_value &&
+			pgm_tsi_equal (&skb->tsi, &((pgm_peer_t*)sock->last_hash_value)->tsi)))
 	{
 		*source = sock->last_hash_value;
 	}
 	else
 	{
 		pgm_rwlock_reader_lock (&sock->peers_lock);
-		*source = pgm_hashtable_lookup_extended (sock->peers_hashtable, &skb->tsi, &sock->last_hash_key);
+		*source = pgm_hashtable_lookup (sock->peers_hashtable, &skb->tsi);
 		pgm_rwlock_reader_unlock (&sock->peers_lock);
 		if (PGM_UNLIKELY(NULL == *source)) {
+/* data packet checksums are deferred to receive window admission, verify
+ * before creating a peer from a corrupt TSI.
+ */
+			if ((PGM_ODATA == skb->pgm_header->pgm_type ||
+			     PGM_RDATA == skb->pgm_header->pgm_type) &&
+			    !sock->use_checksum_offload &&
+			    PGM_UNLIKELY(!pgm_verify_checksum (skb)))
+			{
+				pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded data packet on PGM checksum mismatch."));
+				if (sock->can_send_data)
+					sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS]++;
+				goto out_discarded;
+			}
 			*source = pgm_new_peer (sock,
 					       &skb->tsi,
 					       (struct sockaddr*)src_addr, pgm_sockaddr_len(src_addr),
@@ -456,8 +912,13 @@ on_downstream (
 		sock->last_hash_value = *source;
 	}
 
-	(*source)->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED] += skb->len;
-	(*source)->last_packet = skb->tstamp;
+/* data packets are accounted after checksum verification in pgm_on_data() */
+	if (PGM_ODATA != skb->pgm_header->pgm_type &&
+	    PGM_RDATA != skb->pgm_header->pgm_type)
+	{
+		(*source)->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED] += skb->len;
+		(*source)->last_packet = skb->tstamp;
+	}
 
 	skb->data       = (void*)( skb->pgm_header + 1 );
 	skb->len       -= sizeof(struct pgm_header);
@@ -467,8 +928,8 @@ on_downstream (
 	case PGM_ODATA:
 	case PGM_RDATA:
 		if (PGM_UNLIKELY(!pgm_on_data (sock, *source, skb)))
-			goto out_discarded;
-		sock->rx_buffer = pgm_alloc_skb (sock->max_tpdu);
+			return FALSE;
+		sock->rx_buffer = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
 		break;
 
 	case PGM_NCF:
@@ -554,6 +1015,32 @@ on_pgm (
 	return FALSE;
 }
 
+/* data from a source with PGM_UDP_CSUM_OFFLOAD carries no PGM checksum and
+ * is discarded unless the option is enabled here too.  the option is not
+ * negotiated so report the mismatch once.
+ */
+
+static
+void
+check_checksum_offload (
+	pgm_sock_t*		    const restrict sock,
+	const struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	const struct pgm_header* header = skb->data;
+
+	if (PGM_LIKELY(sock->has_warned_checksum_offload) ||
+	    sock->use_checksum_offload ||
+	    IPPROTO_UDP != sock->protocol ||
+	    skb->len < sizeof(struct pgm_header))
+		return;
+	if (0 != header->pgm_checksum ||
+	    (PGM_ODATA != header->pgm_type && PGM_RDATA != header->pgm_type))
+		return;
+	sock->has_warned_checksum_offload = TRUE;
+	pgm_warn (_("Discarding data without PGM checksum, source requires PGM_UDP_CSUM_OFFLOAD."));
+}
+
 /* block on receiving socket whilst holding sock::waiting-mutex
  * returns EAGAIN for waiting data, returns EINTR for waiting timer event,
  * returns ENOENT on closed sock, and returns EFAULT for libc error.
@@ -750,6 +1237,15 @@ pgm_recvmsgv (
 
 recv_again:
 
+#ifdef HAVE_RECVMMSG
+	if (sock->rx_ring)
+		len = recvskb_ring (sock,
+				    (struct sockaddr*)&src,
+				    sizeof(src),
+				    (struct sockaddr*)&dst,
+				    sizeof(dst));
+	else
+#endif
 	len = recvskb (sock,
 		       sock->rx_buffer,		/* PGM skbuff */
 		       0,
@@ -785,7 +1281,7 @@ recv_again:
 
 	pgm_error_t* err = NULL;
 	const bool is_valid = (sock->udp_encap_ucast_port || AF_INET6 == src.ss_family) ?
-					pgm_parse_udp_encap (sock->rx_buffer, &err) :
+					pgm_parse_udp_encap (sock->rx_buffer, sock->use_checksum_offload, &err) :
 					pgm_parse_raw (sock->rx_buffer, (struct sockaddr*)&dst, &err);
 	if (PGM_UNLIKELY(!is_valid))
 	{
@@ -793,17 +1289,23 @@ recv_again:
 		pgm_trace (PGM_LOG_ROLE_NETWORK,
 				_("Discarded invalid packet: %s"),
 				(err && err->message) ? err->message : "(null)");
-		pgm_error_free (err);
+		if (err && PGM_ERROR_PROTO == err->code)
+			check_checksum_offload (sock, sock->rx_buffer);
 		if (sock->can_send_data) {
 			if (err && PGM_ERROR_CKSUM == err->code)
 				sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS]++;
 			sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
 		}
+		pgm_error_free (err);
 		goto recv_again;
 	}
 
 	pgm_peer_t* source = NULL;
-	if (PGM_UNLIKELY(!on_pgm (sock, sock->rx_buffer, (struct sockaddr*)&src, (struct sockaddr*)&dst, &source)))
+	const bool is_accepted = on_pgm (sock, sock->rx_buffer, (struct sockaddr*)&src, (struct sockaddr*)&dst, &source);
+/* receive window timers may have been brought forward */
+	if (NULL != source)
+		pgm_peer_update_expiry (sock, source);
+	if (PGM_UNLIKELY(!is_accepted))
 		goto recv_again;
 
 /* check whether this source has waiting data */
@@ -812,6 +1314,10 @@ recv_again:
 		pgm_peer_set_pending (sock, source);
 	}
 
+/* demux remainder of a batched read before flushing to the application */
+	if (sock->rx_ring_offset < sock->rx_ring_len)
+		goto recv_again;
+
 flush_pending:
 /* flush any congtiguous packets generated by the receipt of this packet */
 	if (sock->peers_pending)
@@ -19,6 +19,9 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
 #ifndef _GNU_SOURCE
 #	define _GNU_SOURCE
 #endif
@@ -83,10 +86,19 @@ static gboolean mock_data_on_spmr = FALSE;
 static struct pgm_peer_t* mock_peer = NULL;
 GList* mock_data_list = NULL;
 unsigned mock_pgm_loss_rate = 0;
+static unsigned mock_data_count = 0;
+static gsize mock_data_last_len = 0;
+static unsigned mock_recvmmsg_calls = 0;
+static gboolean mock_require_checksum = FALSE;
 
 
 #ifndef _WIN32
 static ssize_t mock_recvmsg (int, struct msghdr*, int);
+#	ifdef HAVE_RECVMMSG
+struct mmsghdr;
+struct timespec;
+static int mock_recvmmsg (int, struct mmsghdr*, unsigned int, int, struct timespec*);
+#	endif
 #else
 static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #endif
@@ -96,12 +108,14 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_verify_spm			mock_pgm_verify_spm
 #define pgm_verify_nak			mock_pgm_verify_nak
 #define pgm_verify_ncf			mock_pgm_verify_ncf
+#define pgm_verify_checksum		mock_pgm_verify_checksum
 #define pgm_select_info			mock_pgm_select_info
 #define pgm_poll_info			mock_pgm_poll_info
 #define pgm_set_reset_error		mock_pgm_set_reset_error
 #define pgm_flush_peers_pending		mock_pgm_flush_peers_pending
 #define pgm_peer_has_pending		mock_pgm_peer_has_pending
 #define pgm_peer_set_pending		mock_pgm_peer_set_pending
+#define pgm_peer_update_expiry		mock_pgm_peer_update_expiry
 #define pgm_txw_retransmit_is_empty	mock_pgm_txw_retransmit_is_empty
 #define pgm_rxw_create			mock_pgm_rxw_create
 #define pgm_rxw_readv			mock_pgm_rxw_readv
@@ -123,6 +137,7 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_time_now			mock_pgm_time_now
 #define pgm_time_update_now		mock_pgm_time_update_now
 #define recvmsg				mock_recvmsg
+#define recvmmsg			mock_recvmmsg
 #define recvfrom			mock_recvfrom
 #define pgm_WSARecvMsg			mock_pgm_WSARecvMsg
 #define pgm_loss_rate			mock_pgm_loss_rate
@@ -155,6 +170,10 @@ mock_teardown (void)
 	mock_peer = NULL;
 	mock_data_list = NULL;
 	mock_pgm_loss_rate = 0;
+	mock_data_count = 0;
+	mock_data_last_len = 0;
+	mock_recvmmsg_calls = 0;
+	mock_require_checksum = FALSE;
 }
 
 static
@@ -579,10 +598,21 @@ mock_pgm_parse_raw (
 bool
 mock_pgm_parse_udp_encap (
 	struct pgm_sk_buff_t* const	skb,
+	const bool			trust_checksum,
 	pgm_error_t**			error
 	)
 {
 	skb->pgm_header = skb->data;
+	if (mock_require_checksum && !trust_checksum && 0 == skb->pgm_header->pgm_checksum &&
+	    (PGM_ODATA == skb->pgm_header->pgm_type || PGM_RDATA == skb->pgm_header->pgm_type))
+	{
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_PACKET,
+			     PGM_ERROR_PROTO,
+			     "PGM checksum missing whilst mandatory for %cDATA packets.",
+			     PGM_ODATA == skb->pgm_header->pgm_type ? 'O' : 'R');
+		return FALSE;
+	}
 	memcpy (&skb->tsi.gsi, skb->pgm_header->pgm_gsi, sizeof(pgm_gsi_t));
 	skb->tsi.sport = skb->pgm_header->pgm_sport;
 	return TRUE;
@@ -612,6 +642,14 @@ mock_pgm_verify_ncf (
 	return TRUE;
 }
 
+bool
+mock_pgm_verify_checksum (
+	struct pgm_sk_buff_t* const		skb
+	)
+{
+	return TRUE;
+}
+
 /** socket module */
 #ifdef HAVE_POLL
 int
@@ -746,6 +784,17 @@ mock_pgm_peer_set_pending (
 	sock->peers_pending = &peer->pending_link;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_peer_update_expiry (
+	pgm_sock_t* const		sock,
+	pgm_peer_t* const		peer
+	)
+{
+	g_assert (NULL != sock);
+	g_assert (NULL != peer);
+}
+
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_on_data (
@@ -757,6 +806,8 @@ mock_pgm_on_data (
 	g_debug ("mock_pgm_on_data (sock:%p sender:%p skb:%p)",
 		(gpointer)sock, (gpointer)sender, (gpointer)skb);
 	mock_pgm_type = PGM_ODATA;
+	mock_data_count++;
+	mock_data_last_len = skb->len;
 	((pgm_rxw_t*)sender->window)->has_event = 1;
 	return TRUE;
 }
@@ -1010,6 +1061,41 @@ mock_recvmsg (
 	errno = mock_errno;
 	return mock_retval;
 }
+
+#	ifdef HAVE_RECVMMSG
+/* fill up to vlen messages from the recvmsg list, a blocking event ends the
+ * batch and is only returned on an otherwise empty read.
+ */
+static
+int
+mock_recvmmsg (
+	int			s,
+	struct mmsghdr*		msgvec,
+	unsigned int		vlen,
+	int			flags,
+	struct timespec*	timeout
+	)
+{
+	g_assert (NULL != msgvec);
+	g_assert (NULL != mock_recvmsg_list);
+
+	g_debug ("mock_recvmmsg (s:%d msgvec:%p vlen:%u flags:%d timeout:%p)",
+		s, (gpointer)msgvec, vlen, flags, (gpointer)timeout);
+
+	mock_recvmmsg_calls++;
+	unsigned i;
+	for (i = 0; i < vlen && NULL != mock_recvmsg_list; i++) {
+		const struct mock_recvmsg_t* mr = mock_recvmsg_list->data;
+		if (mr->mr_retval < 0) {
+			if (i > 0)
+				break;
+			return (int)mock_recvmsg (s, &msgvec[i].msg_hdr, flags);
+		}
+		msgvec[i].msg_len = (unsigned)mock_recvmsg (s, &msgvec[i].msg_hdr, flags);
+	}
+	return (int)i;
+}
+#	endif /* HAVE_RECVMMSG */
 #else
 static
 int
@@ -1171,6 +1257,35 @@ START_TEST (test_data_pass_001)
 }
 END_TEST
 
+/* data without a PGM checksum from a PGM_UDP_CSUM_OFFLOAD source is discarded
+ * and reported once.
+ */
+START_TEST (test_data_pass_002)
+{
+	const char source[] = "i am not a string";
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->protocol = IPPROTO_UDP;
+	sock->udp_encap_ucast_port = g_htons (3055);
+	mock_require_checksum = TRUE;
+	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
+	for (guint32 i = 0; i < 2; i++) {
+		gpointer packet; gsize packet_len;
+		generate_odata (source, sizeof(source), i /* sqn */, -1 /* trail */, &packet, &packet_len);
+		generate_msghdr (packet, packet_len);
+/* UDP payload is the PGM packet */
+		memmove (packet, (guint8*)packet + sizeof(struct pgm_ip), packet_len - sizeof(struct pgm_ip));
+	}
+	push_block_event ();
+	gsize bytes_read;
+	pgm_error_t* err = NULL;
+	pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err);
+	fail_unless (-1 == mock_pgm_type, "unexpected PGM packet");
+	fail_unless (2 == sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED], "packets not discarded");
+	fail_unless (TRUE == sock->has_warned_checksum_offload, "mismatch not reported");
+}
+END_TEST
+
 /* recv -> on_spm */
 START_TEST (test_spm_pass_001)
 {
@@ -1569,6 +1684,119 @@ START_TEST (test_on_many_data_pass_001)
 }
 END_TEST
 
+#ifdef HAVE_RECVMMSG
+/* batched reads refill the receive ring when exhausted and drain it across
+ * calls.
+ */
+START_TEST (test_ring_pass_001)
+{
+	const char source[] = "i am not a string";
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->rx_ring_size = 2;
+	sock->rx_ring = g_new0 (struct pgm_rx_slot_t, sock->rx_ring_size);
+	for (unsigned i = 0; i < sock->rx_ring_size; i++)
+		sock->rx_ring[i].skb = pgm_alloc_skb (TEST_MAX_TPDU);
+	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
+	gpointer packet; gsize packet_len;
+	for (guint32 i = 0; i < 3; i++) {
+		generate_odata (source, sizeof(source), i /* sqn */, -1 /* trail */, &packet, &packet_len);
+		generate_msghdr (packet, packet_len);
+	}
+	push_block_event ();
+	gsize bytes_read;
+	pgm_error_t* err = NULL;
+/* full ring, partial ring, then blocked */
+	fail_unless (PGM_IO_STATUS_TIMER_PENDING == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
+	fail_unless (3 == mock_data_count, "packets not demuxed");
+	fail_unless (3 == mock_recvmmsg_calls, "unexpected batch reads");
+	fail_unless (NULL == mock_recvmsg_list, "packets not read");
+	fail_unless (sock->rx_ring_offset == sock->rx_ring_len, "ring not drained");
+/* next call reads a fresh batch */
+	generate_odata (source, sizeof(source), 3 /* sqn */, -1 /* trail */, &packet, &packet_len);
+	generate_msghdr (packet, packet_len);
+	push_block_event ();
+	fail_unless (PGM_IO_STATUS_TIMER_PENDING == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
+	fail_unless (4 == mock_data_count, "packets not demuxed");
+	fail_unless (5 == mock_recvmmsg_calls, "unexpected batch reads");
+	fail_unless (NULL == mock_recvmsg_list, "packets not read");
+	fail_unless (sock->rx_ring_offset == sock->rx_ring_len, "ring not drained");
+}
+END_TEST
+#	ifdef UDP_GRO
+/* one coalesced buffer of segments smaller than the maximum TPDU, with a short
+ * final segment, is re-split into one ring skbuff per segment.
+ */
+START_TEST (test_gro_pass_001)
+{
+	const char* source[] = {
+		"i am not a string",
+		"i am not an iguana",
+		"i am"
+	};
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->udp_encap_ucast_port = g_htons (3055);
+	sock->use_udp_gro = TRUE;
+	sock->rx_ring_size = 4;
+	sock->rx_ring = g_new0 (struct pgm_rx_slot_t, sock->rx_ring_size);
+	for (unsigned i = 0; i < sock->rx_ring_size; i++)
+		sock->rx_ring[i].skb = pgm_alloc_skb (TEST_MAX_TPDU);
+	sock->rx_gro_buffer = g_malloc0 (UINT16_MAX);
+/* equal sized segments padded to the longest payload, except the last */
+	const gsize gso_size = sizeof(struct pgm_header) + sizeof(struct pgm_data) + strlen(source[1]) + 1;
+	guint8 gro[ 3 * TEST_MAX_TPDU ];
+	gsize gro_len = 0;
+	for (guint32 i = 0; i < G_N_ELEMENTS(source); i++) {
+		gpointer packet; gsize packet_len;
+		generate_odata (source[i], strlen(source[i]) + 1, i /* sqn */, -1 /* trail */, &packet, &packet_len);
+		packet_len -= sizeof(struct pgm_ip);
+		memset (&gro[ gro_len ], 0, gso_size);
+		memcpy (&gro[ gro_len ], (guint8*)packet + sizeof(struct pgm_ip), packet_len);
+		gro_len += (i < G_N_ELEMENTS(source) - 1) ? gso_size : packet_len;
+	}
+	struct sockaddr_in addr = {
+		.sin_family		= AF_INET,
+		.sin_addr.s_addr	= inet_addr (TEST_SRC_ADDR)
+	};
+	struct pgm_iovec iov = {
+		.iov_base		= gro,
+		.iov_len		= gro_len
+	};
+	const size_t control_len = CMSG_SPACE(sizeof(int));
+	struct cmsghdr* cmsg = g_malloc0 (control_len);
+	const int segment_size = (int)gso_size;
+	cmsg->cmsg_len		= CMSG_LEN(sizeof(int));
+	cmsg->cmsg_level	= SOL_UDP;
+	cmsg->cmsg_type		= UDP_GRO;
+	memcpy (CMSG_DATA(cmsg), &segment_size, sizeof(int));
+	struct msghdr gro_msg = {
+		.msg_name		= g_memdup (&addr, sizeof(addr)),
+		.msg_namelen		= sizeof(addr),
+		.msg_iov		= g_memdup (&iov, sizeof(iov)),
+		.msg_iovlen		= 1,
+		.msg_control		= cmsg,
+		.msg_controllen		= control_len,
+		.msg_flags		= 0
+	};
+	struct mock_recvmsg_t* mr = g_malloc (sizeof(struct mock_recvmsg_t));
+	mr->mr_msg	= g_memdup (&gro_msg, sizeof(gro_msg));
+	mr->mr_errno	= 0;
+	mr->mr_retval	= gro_len;
+	mock_recvmsg_list = g_list_append (mock_recvmsg_list, mr);
+	push_block_event ();
+	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
+	gsize bytes_read;
+	pgm_error_t* err = NULL;
+	fail_unless (PGM_IO_STATUS_TIMER_PENDING == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
+	fail_unless (G_N_ELEMENTS(source) == mock_data_count, "segments not demuxed");
+	fail_unless (sizeof(struct pgm_data) + strlen(source[2]) + 1 == mock_data_last_len, "unexpected final segment length");
+	fail_unless (NULL == mock_recvmsg_list, "buffer not read");
+}
+END_TEST
+#	endif /* UDP_GRO */
+#endif /* HAVE_RECVMMSG */
+
 START_TEST (test_recv_fail_001)
 {
 	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
@@ -1654,6 +1882,7 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_data);
 	tcase_add_checked_fixture (tc_data, mock_setup, mock_teardown);
 	tcase_add_test (tc_data, test_data_pass_001);
+	tcase_add_test (tc_data, test_data_pass_002);
 
 	TCase* tc_spm = tcase_create ("spm");
 	suite_add_tcase (s, tc_spm);
@@ -1725,6 +1954,19 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_on_many_data, mock_setup, mock_teardown);
 	tcase_add_test (tc_on_many_data, test_on_many_data_pass_001);
 
+#ifdef HAVE_RECVMMSG
+	TCase* tc_ring = tcase_create ("ring");
+	suite_add_tcase (s, tc_ring);
+	tcase_add_checked_fixture (tc_ring, mock_setup, mock_teardown);
+	tcase_add_test (tc_ring, test_ring_pass_001);
+#	ifdef UDP_GRO
+	TCase* tc_gro = tcase_create ("gro");
+	suite_add_tcase (s, tc_gro);
+	tcase_add_checked_fixture (tc_gro, mock_setup, mock_teardown);
+	tcase_add_test (tc_gro, test_gro_pass_001);
+#	endif
+#endif
+
 	TCase* tc_recv = tcase_create ("recv");
 	suite_add_tcase (s, tc_recv);
 	tcase_add_checked_fixture (tc_recv, mock_setup, mock_teardown);
@@ -30,14 +30,34 @@
 #include <impl/framework.h>
 
 
+/* SIMD multiply-accumulate kernels are selected at run time from the CPU
+ * feature flags, the scalar loop remains the fallback.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || defined(__clang__))
+#	include <immintrin.h>
+#	define USE_GALOIS_SSSE3
+#	define USE_GALOIS_AVX2
+#	if (defined(__GNUC__) && __GNUC__ >= 6) || defined(__clang__)
+#		define USE_GALOIS_AVX512
+#	endif
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#	include <arm_neon.h>
+#	define USE_GALOIS_NEON
+#endif
+
+
 /* Vector GF(2⁸) plus-equals multiplication.
  *
  * d[] += b • s[]
  */
 
+typedef void (*pgm_gf_vec_addmul_func)(pgm_gf8_t*restrict, const pgm_gf8_t, const pgm_gf8_t*restrict, uint16_t);
+
 static
 void
-_pgm_gf_vec_addmul (
+_pgm_gf_vec_addmul_scalar (
 	pgm_gf8_t*	 restrict d,
 	const pgm_gf8_t		  b,
 	const pgm_gf8_t* restrict s,
@@ -69,14 +89,14 @@ _pgm_gf_vec_addmul (
 			d[i+6] ^= gfmul_b[ s[i+6] ];
 			d[i+7] ^= gfmul_b[ s[i+7] ];
 #else
-			d[i  ] ^= gfmul( b, s[i  ] );
-			d[i+1] ^= gfmul( b, s[i+1] );
-			d[i+2] ^= gfmul( b, s[i+2] );
-			d[i+3] ^= gfmul( b, s[i+3] );
-			d[i+4] ^= gfmul( b, s[i+4] );
-			d[i+5] ^= gfmul( b, s[i+5] );
-			d[i+6] ^= gfmul( b, s[i+6] );
-			d[i+7] ^= gfmul( b, s[i+7] );
+			d[i  ] ^= pgm_gfmul( b, s[i  ] );
+			d[i+1] ^= pgm_gfmul( b, s[i+1] );
+			d[i+2] ^= pgm_gfmul( b, s[i+2] );
+			d[i+3] ^= pgm_gfmul( b, s[i+3] );
+			d[i+4] ^= pgm_gfmul( b, s[i+4] );
+			d[i+5] ^= pgm_gfmul( b, s[i+5] );
+			d[i+6] ^= pgm_gfmul( b, s[i+6] );
+			d[i+7] ^= pgm_gfmul( b, s[i+7] );
 #endif
 			i += 8;
 		}
@@ -89,12 +109,210 @@ _pgm_gf_vec_addmul (
 #ifdef USE_GALOIS_MUL_LUT
 		d[i] ^= gfmul_b[ s[i] ];
 #else
-		d[i] ^= gfmul( b, s[i] );
+		d[i] ^= pgm_gfmul( b, s[i] );
 #endif
 		i++;
 	}
 }
 
+#if defined(USE_GALOIS_SSSE3) || defined(USE_GALOIS_NEON)
+/* split-nibble products for table lookup by byte shuffle:
+ *
+ * b • s = lo[ s & 0xf ] ⊕ hi[ s >> 4 ]
+ */
+
+static
+void
+_pgm_gf_nibble_tables (
+	const pgm_gf8_t		  b,
+	pgm_gf8_t*	 restrict lo,	/* 16 entries */
+	pgm_gf8_t*	 restrict hi
+	)
+{
+	for (unsigned x = 0; x < 16; x++) {
+		lo[ x ] = pgm_gfmul (b, (pgm_gf8_t)x);
+		hi[ x ] = pgm_gfmul (b, (pgm_gf8_t)(x << 4));
+	}
+}
+#endif
+
+#ifdef USE_GALOIS_SSSE3
+__attribute__((target("ssse3")))
+static
+void
+_pgm_gf_vec_addmul_ssse3 (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	pgm_gf8_t lo[ 16 ], hi[ 16 ];
+	uint_fast16_t i = 0;
+
+	if (PGM_UNLIKELY(b == 0))
+		return;
+	if (len < 16) {
+		_pgm_gf_vec_addmul_scalar (d, b, s, len);
+		return;
+	}
+
+	_pgm_gf_nibble_tables (b, lo, hi);
+	const __m128i tlo  = _mm_loadu_si128 ((const __m128i*)lo);
+	const __m128i thi  = _mm_loadu_si128 ((const __m128i*)hi);
+	const __m128i mask = _mm_set1_epi8 (0x0f);
+	for (; i + 16 <= len; i += 16) {
+		const __m128i x = _mm_loadu_si128 ((const __m128i*)&s[ i ]);
+		const __m128i l = _mm_shuffle_epi8 (tlo, _mm_and_si128 (x, mask));
+		const __m128i h = _mm_shuffle_epi8 (thi, _mm_and_si128 (_mm_srli_epi64 (x, 4), mask));
+		const __m128i y = _mm_loadu_si128 ((const __m128i*)&d[ i ]);
+		_mm_storeu_si128 ((__m128i*)&d[ i ], _mm_xor_si128 (y, _mm_xor_si128 (l, h)));
+	}
+	_pgm_gf_vec_addmul_scalar (&d[ i ], b, &s[ i ], len - i);
+}
+#endif /* USE_GALOIS_SSSE3 */
+
+#ifdef USE_GALOIS_AVX2
+__attribute__((target("avx2")))
+static
+void
+_pgm_gf_vec_addmul_avx2 (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	pgm_gf8_t lo[ 16 ], hi[ 16 ];
+	uint_fast16_t i = 0;
+
+	if (PGM_UNLIKELY(b == 0))
+		return;
+	if (len < 32) {
+		_pgm_gf_vec_addmul_scalar (d, b, s, len);
+		return;
+	}
+
+	_pgm_gf_nibble_tables (b, lo, hi);
+/* shuffle operates within each 128-bit lane */
+	const __m256i tlo  = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*)lo));
+	const __m256i thi  = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*)hi));
+	const __m256i mask = _mm256_set1_epi8 (0x0f);
+	for (; i + 32 <= len; i += 32) {
+		const __m256i x = _mm256_loadu_si256 ((const __m256i*)&s[ i ]);
+		const __m256i l = _mm256_shuffle_epi8 (tlo, _mm256_and_si256 (x, mask));
+		const __m256i h = _mm256_shuffle_epi8 (thi, _mm256_and_si256 (_mm256_srli_epi64 (x, 4), mask));
+		const __m256i y = _mm256_loadu_si256 ((const __m256i*)&d[ i ]);
+		_mm256_storeu_si256 ((__m256i*)&d[ i ], _mm256_xor_si256 (y, _mm256_xor_si256 (l, h)));
+	}
+	_pgm_gf_vec_addmul_scalar (&d[ i ], b, &s[ i ], len - i);
+}
+#endif /* USE_GALOIS_AVX2 */
+
+#ifdef USE_GALOIS_AVX512
+__attribute__((target("avx512f,avx512bw")))
+static
+void
+_pgm_gf_vec_addmul_avx512 (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	pgm_gf8_t lo[ 16 ], hi[ 16 ];
+	uint_fast16_t i = 0;
+
+	if (PGM_UNLIKELY(b == 0))
+		return;
+	if (len < 64) {
+		_pgm_gf_vec_addmul_scalar (d, b, s, len);
+		return;
+	}
+
+	_pgm_gf_nibble_tables (b, lo, hi);
+	const __m512i tlo  = _mm512_broadcast_i32x4 (_mm_loadu_si128 ((const __m128i*)lo));
+	const __m512i thi  = _mm512_broadcast_i32x4 (_mm_loadu_si128 ((const __m128i*)hi));
+	const __m512i mask = _mm512_set1_epi8 (0x0f);
+	for (; i + 64 <= len; i += 64) {
+		const __m512i x = _mm512_loadu_si512 ((const void*)&s[ i ]);
+		const __m512i l = _mm512_shuffle_epi8 (tlo, _mm512_and_si512 (x, mask));
+		const __m512i h = _mm512_shuffle_epi8 (thi, _mm512_and_si512 (_mm512_srli_epi64 (x, 4), mask));
+		const __m512i y = _mm512_loadu_si512 ((const void*)&d[ i ]);
+		_mm512_storeu_si512 ((void*)&d[ i ], _mm512_xor_si512 (y, _mm512_xor_si512 (l, h)));
+	}
+	_pgm_gf_vec_addmul_scalar (&d[ i ], b, &s[ i ], len - i);
+}
+#endif /* USE_GALOIS_AVX512 */
+
+#ifdef USE_GALOIS_NEON
+static
+void
+_pgm_gf_vec_addmul_neon (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	pgm_gf8_t lo[ 16 ], hi[ 16 ];
+	uint_fast16_t i = 0;
+
+	if (PGM_UNLIKELY(b == 0))
+		return;
+	if (len < 16) {
+		_pgm_gf_vec_addmul_scalar (d, b, s, len);
+		return;
+	}
+
+	_pgm_gf_nibble_tables (b, lo, hi);
+	const uint8x16_t tlo  = vld1q_u8 (lo);
+	const uint8x16_t thi  = vld1q_u8 (hi);
+	const uint8x16_t mask = vdupq_n_u8 (0x0f);
+	for (; i + 16 <= len; i += 16) {
+		const uint8x16_t x = vld1q_u8 (&s[ i ]);
+		const uint8x16_t l = vqtbl1q_u8 (tlo, vandq_u8 (x, mask));
+		const uint8x16_t h = vqtbl1q_u8 (thi, vshrq_n_u8 (x, 4));
+		vst1q_u8 (&d[ i ], veorq_u8 (vld1q_u8 (&d[ i ]), veorq_u8 (l, h)));
+	}
+	_pgm_gf_vec_addmul_scalar (&d[ i ], b, &s[ i ], len - i);
+}
+#endif /* USE_GALOIS_NEON */
+
+static pgm_gf_vec_addmul_func _pgm_gf_vec_addmul PGM_GNUC_READ_MOSTLY = _pgm_gf_vec_addmul_scalar;
+
+/* select the widest multiply-accumulate kernel supported by this processor,
+ * called once from pgm_init().
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rs_init (void)
+{
+#if defined(USE_GALOIS_SSSE3)
+	__builtin_cpu_init ();
+#	ifdef USE_GALOIS_AVX512
+	if (__builtin_cpu_supports ("avx512bw")) {
+		_pgm_gf_vec_addmul = _pgm_gf_vec_addmul_avx512;
+		return;
+	}
+#	endif
+	if (__builtin_cpu_supports ("avx2")) {
+		_pgm_gf_vec_addmul = _pgm_gf_vec_addmul_avx2;
+		return;
+	}
+	if (__builtin_cpu_supports ("ssse3")) {
+		_pgm_gf_vec_addmul = _pgm_gf_vec_addmul_ssse3;
+		return;
+	}
+#elif defined(USE_GALOIS_NEON)
+/* Advanced SIMD is mandatory on AArch64 */
+	_pgm_gf_vec_addmul = _pgm_gf_vec_addmul_neon;
+	return;
+#endif
+	_pgm_gf_vec_addmul = _pgm_gf_vec_addmul_scalar;
+}
+
 /* Basic matrix multiplication.
  *
  * C = AB
@@ -353,8 +571,9 @@ pgm_rs_create (
 
 	rs->n	= n;
 	rs->k	= k;
+	rs->is_cauchy = FALSE;
 	rs->GM	= pgm_new0 (pgm_gf8_t, n * k);
-	rs->RM	= pgm_new0 (pgm_gf8_t, k * k);
+	rs->rm_len = 0;
 
 /* alpha = root of primitive polynomial of degree m
  *                 ( 1 + x² + x³ + x⁴ + x⁸ )
@@ -413,6 +632,61 @@ pgm_rs_create (
 	}
 }
 
+/* Cauchy generator matrix, the parity rows are formed directly without
+ * inversion from a Cauchy matrix whose every square submatrix is non-singular.
+ *
+ * C_{i,j} = 1 / (x_i + y_j)
+ *
+ * where x_i = k + i and y_j = j are distinct field elements for n ≤ 2⁸ - 1.
+ * Each column is then scaled by the inverse of its first entry such that the
+ * first parity packet is the XOR of the original data, scaling a column
+ * preserves the MDS property.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rs_create_cauchy (
+	pgm_rs_t*		rs,
+	const uint8_t		n,
+	const uint8_t		k
+	)
+{
+	pgm_assert (NULL != rs);
+	pgm_assert (n > 0);
+	pgm_assert (k > 0);
+
+	rs->n	= n;
+	rs->k	= k;
+	rs->is_cauchy = TRUE;
+	rs->GM	= pgm_new0 (pgm_gf8_t, n * k);
+	rs->rm_len = 0;
+
+/* identity matrix for original data */
+	for (uint_fast8_t i = 0; i < k; i++)
+	{
+		rs->GM[ (i * k) + i ] = 1;
+	}
+
+	pgm_gf8_t* C = rs->GM + (k * k);
+	for (uint_fast8_t i = 0; i < (n - k); i++)
+	{
+		for (uint_fast8_t j = 0; j < k; j++)
+		{
+			C[ (i * k) + j ] = pgm_gfdiv (1, (pgm_gf8_t)((k + i) ^ j));
+		}
+	}
+
+	if (n > k)
+	{
+		for (uint_fast8_t j = 0; j < k; j++)
+		{
+			const pgm_gf8_t c = C[ j ];
+			for (uint_fast8_t i = 0; i < (n - k); i++)
+				C[ (i * k) + j ] = pgm_gfdiv (C[ (i * k) + j ], c);
+		}
+	}
+}
+
 PGM_GNUC_INTERNAL
 void
 pgm_rs_destroy (
@@ -421,10 +695,11 @@ pgm_rs_destroy (
 {
 	pgm_assert (NULL != rs);
 
-	if (rs->RM) {
-		pgm_free (rs->RM);
-		rs->RM = NULL;
+	for (uint_fast8_t i = 0; i < rs->rm_len; i++) {
+		pgm_free (rs->rm_cache[ i ].offsets);
+		pgm_free (rs->rm_cache[ i ].RM);
 	}
+	rs->rm_len = 0;
 
 	if (rs->GM) {
 		pgm_free (rs->GM);
@@ -460,6 +735,158 @@ pgm_rs_encode (
 	}
 }
 
+/* create count consecutive parity packets from a vector of original data
+ * packets in one pass.  the packets are walked in blocks so that each block
+ * of original data is read once and accumulated into every parity packet
+ * while they remain in cache.
+ */
+
+#define PGM_RS_ENCODE_BLOCK	1024
+
+PGM_GNUC_INTERNAL
+void
+pgm_rs_encode_multi (
+	pgm_rs_t*	  restrict rs,
+	const pgm_gf8_t** restrict src,		/* length rs_t::k */
+	const uint8_t		   offset,	/* first parity packet */
+	const uint8_t		   count,
+	pgm_gf8_t**	  restrict dst,		/* length count */
+	const uint16_t		   len
+	)
+{
+	pgm_assert (NULL != rs);
+	pgm_assert (NULL != src);
+	pgm_assert (offset >= rs->k && offset < rs->n);	/* parity packet */
+	pgm_assert (count > 0);
+	pgm_assert (offset + count <= rs->n);
+	pgm_assert (NULL != dst);
+	pgm_assert (len > 0);
+
+	for (uint_fast8_t j = 0; j < count; j++)
+		memset (dst[j], 0, len);
+	for (uint_fast16_t off = 0; off < len; off += PGM_RS_ENCODE_BLOCK)
+	{
+		const uint16_t block_len = (uint16_t)MIN(PGM_RS_ENCODE_BLOCK, len - off);
+		for (uint_fast8_t i = 0; i < rs->k; i++)
+		{
+			for (uint_fast8_t j = 0; j < count; j++)
+			{
+				const pgm_gf8_t c = rs->GM[ ((offset + j) * rs->k) + i ];
+				_pgm_gf_vec_addmul (dst[j] + off, c, src[i] + off, block_len);
+			}
+		}
+	}
+}
+
+/* accumulate one original data packet at FEC block offset index into count
+ * consecutive parity packets, such that folding each of the rs_t::k original
+ * packets into zeroed parity packets yields pgm_rs_encode_multi().  shorter
+ * packets are implicitly zero padded by the caller not folding the tail.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rs_encode_fold (
+	pgm_rs_t*	  restrict rs,
+	const pgm_gf8_t*  restrict src,
+	const uint8_t		   index,	/* original data packet */
+	const uint8_t		   offset,	/* first parity packet */
+	const uint8_t		   count,
+	pgm_gf8_t**	  restrict dst,		/* length count */
+	const uint16_t		   len
+	)
+{
+	pgm_assert (NULL != rs);
+	pgm_assert (NULL != src);
+	pgm_assert (index < rs->k);
+	pgm_assert (offset >= rs->k && offset < rs->n);	/* parity packet */
+	pgm_assert (count > 0);
+	pgm_assert (offset + count <= rs->n);
+	pgm_assert (NULL != dst);
+
+	for (uint_fast8_t j = 0; j < count; j++)
+	{
+		const pgm_gf8_t c = rs->GM[ ((offset + j) * rs->k) + index ];
+		_pgm_gf_vec_addmul (dst[j], c, src, len);
+	}
+}
+
+/* inverted recovery matrix for an erasure pattern, taken from the cache of
+ * recently used patterns when possible as lossy links tend to repeat the same
+ * few patterns.  the least recently used entry is replaced on a miss.
+ */
+
+static
+const pgm_gf8_t*
+_pgm_rs_recovery_matrix (
+	pgm_rs_t*      restrict rs,
+	const uint8_t* restrict offsets		/* length rs_t::k */
+	)
+{
+	struct pgm_rs_rm_t rm;
+	uint_fast8_t i;
+
+	for (i = 0; i < rs->rm_len; i++)
+		if (0 == memcmp (rs->rm_cache[ i ].offsets, offsets, rs->k))
+			break;
+
+	if (i < rs->rm_len)
+	{
+		rm = rs->rm_cache[ i ];
+	}
+	else
+	{
+		if (rs->rm_len < PGM_RS_RM_CACHE) {
+			i = rs->rm_len++;
+			rm.offsets = pgm_new (uint8_t, rs->k);
+			rm.RM	   = pgm_new (pgm_gf8_t, rs->k * rs->k);
+		} else {
+			i = PGM_RS_RM_CACHE - 1;
+			rm = rs->rm_cache[ i ];
+		}
+
+/* only the rows of erased packets are unknown, invert the e × e submatrix of
+ * generator rows of substituted parity packets at erased columns, A, and
+ * fold the present columns, B, through it:
+ *
+ * x_erased = A⁻¹ × y_parity + A⁻¹ × B × x_present
+ */
+		uint8_t* erased = pgm_newa (uint8_t, rs->k);
+		uint_fast8_t e = 0;
+		for (uint_fast8_t j = 0; j < rs->k; j++)
+			if (offsets[ j ] >= rs->k)
+				erased[ e++ ] = (uint8_t)j;
+
+		pgm_gf8_t* A = pgm_newa (pgm_gf8_t, e * e);
+		for (uint_fast8_t r = 0; r < e; r++)
+			for (uint_fast8_t c = 0; c < e; c++)
+				A[ (r * e) + c ] = rs->GM[ (offsets[ erased[ r ] ] * rs->k) + erased[ c ] ];
+		if (e > 0)
+			_pgm_matinv (A, (uint8_t)e);
+
+/* identity rows for present packets */
+		memset (rm.RM, 0, rs->k * rs->k * sizeof(pgm_gf8_t));
+		for (uint_fast8_t j = 0; j < rs->k; j++)
+			if (offsets[ j ] < rs->k)
+				rm.RM[ (j * rs->k) + j ] = 1;
+
+		for (uint_fast8_t r = 0; r < e; r++)
+		{
+			pgm_gf8_t* row = &rm.RM[ erased[ r ] * rs->k ];
+			for (uint_fast8_t c = 0; c < e; c++)
+				_pgm_gf_vec_addmul (row, A[ (r * e) + c ], &rs->GM[ offsets[ erased[ c ] ] * rs->k ], rs->k);
+			for (uint_fast8_t c = 0; c < e; c++)
+				row[ erased[ c ] ] = A[ (r * e) + c ];
+		}
+		memcpy (rm.offsets, offsets, rs->k);
+	}
+
+/* move to front */
+	memmove (&rs->rm_cache[ 1 ], &rs->rm_cache[ 0 ], i * sizeof(struct pgm_rs_rm_t));
+	rs->rm_cache[ 0 ] = rm;
+	return rm.RM;
+}
+
 /* original data block of packets with missing packet entries replaced
  * with on-demand parity packets.
  */
@@ -478,20 +905,7 @@ pgm_rs_decode_parity_inline (
 	pgm_assert (NULL != offsets);
 	pgm_assert (len > 0);
 
-/* create new recovery matrix from generator
- */
-	for (uint_fast8_t i = 0; i < rs->k; i++)
-	{
-		if (offsets[i] < rs->k) {
-			memset (&rs->RM[ i * rs->k ], 0, rs->k * sizeof(pgm_gf8_t));
-			rs->RM[ (i * rs->k) + i ] = 1;
-			continue;
-		}
-		memcpy (&rs->RM[ i * rs->k ], &rs->GM[ offsets[ i ] * rs->k ], rs->k * sizeof(pgm_gf8_t));
-	}
-
-/* invert */
-	_pgm_matinv (rs->RM, rs->k);
+	const pgm_gf8_t* RM = _pgm_rs_recovery_matrix (rs, offsets);
 
 	pgm_gf8_t* repairs[ rs->k ];
 
@@ -510,7 +924,7 @@ pgm_rs_decode_parity_inline (
 		for (uint_fast8_t i = 0; i < rs->k; i++)
 		{
 			pgm_gf8_t* src = block[ i ];
-			pgm_gf8_t c = rs->RM[ (j * rs->k) + i ];
+			pgm_gf8_t c = RM[ (j * rs->k) + i ];
 			_pgm_gf_vec_addmul (erasure, c, src, len);
 		}
 	}
@@ -547,20 +961,7 @@ pgm_rs_decode_parity_appended (
 	pgm_assert (NULL != offsets);
 	pgm_assert (len > 0);
 
-/* create new recovery matrix from generator
- */
-	for (uint_fast8_t i = 0; i < rs->k; i++)
-	{
-		if (offsets[i] < rs->k) {
-			memset (&rs->RM[ i * rs->k ], 0, rs->k * sizeof(pgm_gf8_t));
-			rs->RM[ (i * rs->k) + i ] = 1;
-			continue;
-		}
-		memcpy (&rs->RM[ i * rs->k ], &rs->GM[ offsets[ i ] * rs->k ], rs->k * sizeof(pgm_gf8_t));
-	}
-
-/* invert */
-	_pgm_matinv (rs->RM, rs->k);
+	const pgm_gf8_t* RM = _pgm_rs_recovery_matrix (rs, offsets);
 
 /* multiply out, through the length of erasures[] */
 	for (uint_fast8_t j = 0; j < rs->k; j++)
@@ -577,7 +978,7 @@ pgm_rs_decode_parity_appended (
 				src = block[ i ];
 			else
 				src = block[ p++ ];
-			const pgm_gf8_t c = rs->RM[ (j * rs->k) + i ];
+			const pgm_gf8_t c = RM[ (j * rs->k) + i ];
 			_pgm_gf_vec_addmul (erasure, c, src, len);
 		}
 	}
@@ -0,0 +1,322 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * performance tests for Reed-Solomon GF(2⁸) multiply-accumulate kernels
+ *
+ * Copyright (c) 2010 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+
+/* mock state */
+
+static unsigned perf_k		= 0;	/* original data packets */
+static unsigned perf_h		= 0;	/* parity packets */
+static unsigned perf_tpdu	= 0;
+
+
+static
+void
+mock_setup_8_1_1500b (void)
+{
+	perf_k		= 8;
+	perf_h		= 1;
+	perf_tpdu	= 1500;
+}
+
+static
+void
+mock_setup_8_4_1500b (void)
+{
+	perf_k		= 8;
+	perf_h		= 4;
+	perf_tpdu	= 1500;
+}
+
+static
+void
+mock_setup_32_4_1500b (void)
+{
+	perf_k		= 32;
+	perf_h		= 4;
+	perf_tpdu	= 1500;
+}
+
+static
+void
+mock_setup_32_4_9kb (void)
+{
+	perf_k		= 32;
+	perf_h		= 4;
+	perf_tpdu	= 9000;
+}
+
+static
+void
+mock_setup_64_8_9kb (void)
+{
+	perf_k		= 64;
+	perf_h		= 8;
+	perf_tpdu	= 9000;
+}
+
+/* mock functions for external references */
+
+size_t
+pgm_transport_pkt_offset2 (
+        const bool                      can_fragment,
+        const bool                      use_pgmcc
+        )
+{
+	return 0;
+}
+
+#include "reed_solomon.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+static
+void
+mock_setup (void)
+{
+	g_assert (pgm_time_init (NULL));
+}
+
+static
+void
+mock_teardown (void)
+{
+	g_assert (pgm_time_shutdown ());
+}
+
+/* encode perf_h parity packets from perf_k original data packets with the
+ * provided kernel, verified against the scalar kernel.  throughput is of
+ * original data read, i.e. k × h × tpdu per transmission group.
+ */
+
+static
+void
+perf_encode (
+	const char*		name,
+	pgm_gf_vec_addmul_func	func
+	)
+{
+	const unsigned iterations = 1000;
+	pgm_rs_t rs;
+	pgm_gf8_t* source[ perf_k ];
+	pgm_gf8_t* answer[ perf_h ];
+	pgm_gf8_t* parity = g_malloc0 (perf_tpdu);
+	pgm_time_t start, check;
+
+	pgm_rs_create (&rs, perf_k + perf_h, perf_k);
+	for (unsigned i = 0, j = 0; i < perf_k; i++) {
+		source[i] = g_malloc (perf_tpdu);
+		for (unsigned x = 0; x < perf_tpdu; x++) {
+			j = j * 1103515245 + 12345;
+			source[i][x] = j;
+		}
+	}
+	_pgm_gf_vec_addmul = _pgm_gf_vec_addmul_scalar;
+	for (unsigned h = 0; h < perf_h; h++) {
+		answer[h] = g_malloc (perf_tpdu);
+		pgm_rs_encode (&rs, (const pgm_gf8_t**)source, perf_k + h, answer[h], perf_tpdu);
+	}
+
+	_pgm_gf_vec_addmul = func;
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		for (unsigned h = 0; h < perf_h; h++)
+			pgm_rs_encode (&rs, (const pgm_gf8_t**)source, perf_k + h, parity, perf_tpdu);
+	}
+	check = pgm_time_update_now();
+	for (unsigned h = 0; h < perf_h; h++) {
+		pgm_rs_encode (&rs, (const pgm_gf8_t**)source, perf_k + h, parity, perf_tpdu);
+		fail_unless (0 == memcmp (answer[h], parity, perf_tpdu), "parity mismatch");
+	}
+
+	const double bytes = (double)perf_k * perf_h * perf_tpdu * iterations;
+	const pgm_time_t elapsed = MAX(1, check - start);
+	g_message ("%s/k=%u,h=%u,%u: elapsed time %" PGM_TIME_FORMAT " us, %.2f GB/s",
+		name, perf_k, perf_h, perf_tpdu,
+		(guint64)elapsed,
+		bytes / (double)elapsed / 1000.0);
+
+	for (unsigned h = 0; h < perf_h; h++)
+		g_free (answer[h]);
+	for (unsigned i = 0; i < perf_k; i++)
+		g_free (source[i]);
+	g_free (parity);
+	pgm_rs_destroy (&rs);
+}
+
+/* target:
+ *	void
+ *	pgm_rs_encode (
+ *		pgm_rs_t*		rs,
+ *		const pgm_gf8_t**	src,
+ *		const uint8_t		offset,
+ *		pgm_gf8_t*		dst,
+ *		const uint16_t		len
+ *	)
+ */
+
+START_TEST (test_scalar)
+{
+	perf_encode ("scalar", _pgm_gf_vec_addmul_scalar);
+}
+END_TEST
+
+#ifdef USE_GALOIS_SSSE3
+START_TEST (test_ssse3)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("ssse3")) {
+		g_message ("ssse3: not supported by processor");
+		return;
+	}
+	perf_encode ("ssse3", _pgm_gf_vec_addmul_ssse3);
+}
+END_TEST
+#endif
+
+#ifdef USE_GALOIS_AVX2
+START_TEST (test_avx2)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx2")) {
+		g_message ("avx2: not supported by processor");
+		return;
+	}
+	perf_encode ("avx2", _pgm_gf_vec_addmul_avx2);
+}
+END_TEST
+#endif
+
+#ifdef USE_GALOIS_AVX512
+START_TEST (test_avx512)
+{
+	__builtin_cpu_init ();
+	if (!__builtin_cpu_supports ("avx512bw")) {
+		g_message ("avx512: not supported by processor");
+		return;
+	}
+	perf_encode ("avx512", _pgm_gf_vec_addmul_avx512);
+}
+END_TEST
+#endif
+
+#ifdef USE_GALOIS_NEON
+START_TEST (test_neon)
+{
+	perf_encode ("neon", _pgm_gf_vec_addmul_neon);
+}
+END_TEST
+#endif
+
+static
+void
+add_kernel_tests (
+	TCase*		tc
+	)
+{
+	tcase_add_test (tc, test_scalar);
+#ifdef USE_GALOIS_SSSE3
+	tcase_add_test (tc, test_ssse3);
+#endif
+#ifdef USE_GALOIS_AVX2
+	tcase_add_test (tc, test_avx2);
+#endif
+#ifdef USE_GALOIS_AVX512
+	tcase_add_test (tc, test_avx512);
+#endif
+#ifdef USE_GALOIS_NEON
+	tcase_add_test (tc, test_neon);
+#endif
+}
+
+static
+Suite*
+make_encode_performance_suite (void)
+{
+	Suite* s;
+
+	s = suite_create ("Reed-Solomon encode performance");
+
+	TCase* tc_8_1_1500b = tcase_create ("k=8,h=1,1500b");
+	suite_add_tcase (s, tc_8_1_1500b);
+	tcase_add_checked_fixture (tc_8_1_1500b, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_8_1_1500b, mock_setup_8_1_1500b, NULL);
+	add_kernel_tests (tc_8_1_1500b);
+
+	TCase* tc_8_4_1500b = tcase_create ("k=8,h=4,1500b");
+	suite_add_tcase (s, tc_8_4_1500b);
+	tcase_add_checked_fixture (tc_8_4_1500b, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_8_4_1500b, mock_setup_8_4_1500b, NULL);
+	add_kernel_tests (tc_8_4_1500b);
+
+	TCase* tc_32_4_1500b = tcase_create ("k=32,h=4,1500b");
+	suite_add_tcase (s, tc_32_4_1500b);
+	tcase_add_checked_fixture (tc_32_4_1500b, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_32_4_1500b, mock_setup_32_4_1500b, NULL);
+	add_kernel_tests (tc_32_4_1500b);
+
+	TCase* tc_32_4_9kb = tcase_create ("k=32,h=4,9KB");
+	suite_add_tcase (s, tc_32_4_9kb);
+	tcase_add_checked_fixture (tc_32_4_9kb, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_32_4_9kb, mock_setup_32_4_9kb, NULL);
+	add_kernel_tests (tc_32_4_9kb);
+
+	TCase* tc_64_8_9kb = tcase_create ("k=64,h=8,9KB");
+	suite_add_tcase (s, tc_64_8_9kb);
+	tcase_add_checked_fixture (tc_64_8_9kb, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_64_8_9kb, mock_setup_64_8_9kb, NULL);
+	add_kernel_tests (tc_64_8_9kb);
+
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_encode_performance_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
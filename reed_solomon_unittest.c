@@ -79,6 +79,72 @@ START_TEST (test_create_fail_001)
 }
 END_TEST
 
+/* target:
+ *	void
+ *	pgm_rs_create_cauchy (
+ *		pgm_rs_t*		rs,
+ *		const uint8_t		n,
+ *		const uint8_t		k
+ *	)
+ */
+
+/* first parity packet is XOR, any h erasures are recoverable */
+START_TEST (test_create_cauchy_pass_001)
+{
+	pgm_rs_t rs;
+	const guint8 k = 16;
+	const guint8 h = 4;
+	const guint16 packet_len = 200;
+	pgm_gf8_t* original_packets[k];
+	pgm_gf8_t* block[k+h];
+	guint8 offsets[k];
+	pgm_rs_create_cauchy (&rs, k + h, k);
+	for (unsigned j = 0; j < k; j++)
+		fail_unless (1 == rs.GM[ (k * k) + j ], "first parity row not XOR");
+	for (unsigned i = 0; i < k; i++) {
+		original_packets[i] = g_malloc (packet_len);
+		for (unsigned j = 0; j < packet_len; j++)
+			original_packets[i][j] = (pgm_gf8_t)(i * 31 + j * 7);
+		block[i] = g_malloc (packet_len);
+	}
+	for (unsigned i = 0; i < h; i++) {
+		block[k + i] = g_malloc (packet_len);
+		pgm_rs_encode (&rs, (const pgm_gf8_t**)original_packets, k + i, block[k + i], packet_len);
+	}
+/* erase h packets at a sliding stride, parity packets are appended in order */
+	for (unsigned first = 0; first < k; first++) {
+		gboolean is_erased[k];
+		memset (is_erased, 0, sizeof(is_erased));
+		for (unsigned i = 0; i < h; i++)
+			is_erased[ (first + i * 3) % k ] = TRUE;
+		for (unsigned i = 0, p = k; i < k; i++) {
+			if (is_erased[i]) {
+				memset (block[i], 0, packet_len);
+				offsets[i] = p++;
+			} else {
+				memcpy (block[i], original_packets[i], packet_len);
+				offsets[i] = i;
+			}
+		}
+		pgm_rs_decode_parity_appended (&rs, block, offsets, packet_len);
+		for (unsigned i = 0; i < k; i++)
+			fail_unless (0 == memcmp (original_packets[i], block[i], packet_len), "repair mismatch");
+	}
+	for (unsigned i = 0; i < k; i++)
+		g_free (original_packets[i]);
+	for (unsigned i = 0; i < k + h; i++)
+		g_free (block[i]);
+	pgm_rs_destroy (&rs);
+}
+END_TEST
+
+START_TEST (test_create_cauchy_fail_001)
+{
+	pgm_rs_create_cauchy (NULL, 255, 16);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	void
  *	pgm_rs_destroy (
@@ -141,6 +207,107 @@ START_TEST (test_encode_fail_001)
 }
 END_TEST
 
+/* target:
+ *	void
+ *	pgm_rs_encode_multi (
+ *		pgm_rs_t*		rs,
+ *		const pgm_gf8_t**	src,
+ *		const uint8_t		offset,
+ *		const uint8_t		count,
+ *		pgm_gf8_t**		dst,
+ *		const uint16_t		len
+ *	)
+ */
+
+START_TEST (test_encode_multi_pass_001)
+{
+	pgm_rs_t rs;
+	const guint8 k = 16;
+	const guint8 h = 4;
+	const guint16 packet_len = 3000;	/* spans several encoding blocks */
+	pgm_gf8_t* source_packets[k];
+	pgm_gf8_t* parity_packets[h];
+	pgm_gf8_t* answer = g_malloc0 (packet_len);
+	pgm_rs_create (&rs, 255, k);
+	for (unsigned i = 0; i < k; i++) {
+		source_packets[i] = g_malloc0 (packet_len);
+		for (unsigned j = 0; j < packet_len; j++)
+			source_packets[i][j] = (pgm_gf8_t)(i * 31 + j);
+	}
+	for (unsigned i = 0; i < h; i++)
+		parity_packets[i] = g_malloc0 (packet_len);
+	pgm_rs_encode_multi (&rs, (const pgm_gf8_t**)source_packets, k + 1, h, parity_packets, packet_len);
+	for (unsigned i = 0; i < h; i++) {
+		pgm_rs_encode (&rs, (const pgm_gf8_t**)source_packets, k + 1 + i, answer, packet_len);
+		fail_unless (0 == memcmp (answer, parity_packets[i], packet_len), "parity mismatch");
+		g_free (parity_packets[i]);
+	}
+	for (unsigned i = 0; i < k; i++)
+		g_free (source_packets[i]);
+	g_free (answer);
+	pgm_rs_destroy (&rs);
+}
+END_TEST
+
+START_TEST (test_encode_multi_fail_001)
+{
+	pgm_rs_encode_multi (NULL, NULL, 0, 0, NULL, 0);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_rs_encode_fold (
+ *		pgm_rs_t*		rs,
+ *		const pgm_gf8_t*	src,
+ *		const uint8_t		index,
+ *		const uint8_t		offset,
+ *		const uint8_t		count,
+ *		pgm_gf8_t**		dst,
+ *		const uint16_t		len
+ *	)
+ */
+
+/* folding packets of varying length in any order matches encoding the zero padded group */
+START_TEST (test_encode_fold_pass_001)
+{
+	pgm_rs_t rs;
+	const guint8 k = 8;
+	const guint8 h = 3;
+	const guint16 packet_len = 1500;
+	pgm_gf8_t* source_packets[k];
+	pgm_gf8_t* parity_packets[h];
+	pgm_gf8_t* answer = g_malloc0 (packet_len);
+	pgm_rs_create (&rs, 255, k);
+	for (unsigned i = 0; i < k; i++) {
+		source_packets[i] = g_malloc0 (packet_len);
+		for (unsigned j = 0; j < packet_len - i * 100; j++)
+			source_packets[i][j] = (pgm_gf8_t)(i * 31 + j);
+	}
+	for (unsigned i = 0; i < h; i++)
+		parity_packets[i] = g_malloc0 (packet_len);
+	for (unsigned i = k; i > 0; i--)
+		pgm_rs_encode_fold (&rs, source_packets[i - 1], i - 1, k, h, parity_packets, packet_len - (i - 1) * 100);
+	for (unsigned i = 0; i < h; i++) {
+		pgm_rs_encode (&rs, (const pgm_gf8_t**)source_packets, k + i, answer, packet_len);
+		fail_unless (0 == memcmp (answer, parity_packets[i], packet_len), "parity mismatch");
+		g_free (parity_packets[i]);
+	}
+	for (unsigned i = 0; i < k; i++)
+		g_free (source_packets[i]);
+	g_free (answer);
+	pgm_rs_destroy (&rs);
+}
+END_TEST
+
+START_TEST (test_encode_fold_fail_001)
+{
+	pgm_rs_encode_fold (NULL, NULL, 0, 0, 0, NULL, 0);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	void
  *	pgm_rs_decode_parity_inline (
@@ -249,6 +416,47 @@ START_TEST (test_decode_parity_appended_pass_001)
 }
 END_TEST
 
+/* erasure patterns repeating and exceeding the recovery matrix cache */
+START_TEST (test_decode_parity_appended_pass_002)
+{
+	pgm_rs_t rs;
+	const guint8 k = 8;
+	const guint16 packet_len = 100;
+	pgm_gf8_t* original_packets[k];
+	pgm_gf8_t* block[k+1];
+	guint8 offsets[k];
+	pgm_rs_create (&rs, 255, k);
+	for (unsigned i = 0; i < k; i++) {
+		original_packets[i] = g_malloc (packet_len);
+		for (unsigned j = 0; j < packet_len; j++)
+			original_packets[i][j] = (pgm_gf8_t)(i * 31 + j);
+		block[i] = g_malloc (packet_len);
+	}
+	block[k] = g_malloc (packet_len);
+	pgm_rs_encode (&rs, (const pgm_gf8_t**)original_packets, k, block[k], packet_len);
+	for (unsigned round = 0; round < 3; round++) {
+		for (unsigned erased_index = 0; erased_index < PGM_RS_RM_CACHE + 2; erased_index++) {
+			for (unsigned i = 0; i < k; i++) {
+				memcpy (block[i], original_packets[i], packet_len);
+				offsets[i] = i;
+			}
+			memset (block[erased_index], 0, packet_len);
+			offsets[erased_index] = k;
+			pgm_rs_decode_parity_appended (&rs, block, offsets, packet_len);
+			fail_unless (0 == memcmp (original_packets[erased_index], block[erased_index], packet_len), "repair mismatch");
+			fail_unless (rs.rm_len <= PGM_RS_RM_CACHE, "cache overflow");
+			fail_unless (0 == memcmp (rs.rm_cache[0].offsets, offsets, k), "pattern not most recent");
+		}
+	}
+	for (unsigned i = 0; i < k; i++) {
+		g_free (original_packets[i]);
+		g_free (block[i]);
+	}
+	g_free (block[k]);
+	pgm_rs_destroy (&rs);
+}
+END_TEST
+
 START_TEST (test_decode_parity_appended_fail_001)
 {
 	pgm_rs_decode_parity_appended (NULL, NULL, NULL, 0);
@@ -272,6 +480,13 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_create_cauchy = tcase_create ("create-cauchy");
+	suite_add_tcase (s, tc_create_cauchy);
+	tcase_add_test (tc_create_cauchy, test_create_cauchy_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_create_cauchy, test_create_cauchy_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_destroy = tcase_create ("destroy");
 	suite_add_tcase (s, tc_destroy);
 	tcase_add_test (tc_destroy, test_destroy_pass_001);
@@ -286,6 +501,20 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_encode, test_encode_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_encode_multi = tcase_create ("encode-multi");
+	suite_add_tcase (s, tc_encode_multi);
+	tcase_add_test (tc_encode_multi, test_encode_multi_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_encode_multi, test_encode_multi_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_encode_fold = tcase_create ("encode-fold");
+	suite_add_tcase (s, tc_encode_fold);
+	tcase_add_test (tc_encode_fold, test_encode_fold_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_encode_fold, test_encode_fold_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_decode_parity_inline = tcase_create ("decode-parity-inline");
 	suite_add_tcase (s, tc_decode_parity_inline);
 	tcase_add_test (tc_decode_parity_inline, test_decode_parity_inline_pass_001);
@@ -296,6 +525,7 @@ make_test_suite (void)
 	TCase* tc_decode_parity_appended = tcase_create ("decode-parity-appended");
 	suite_add_tcase (s, tc_decode_parity_appended);
 	tcase_add_test (tc_decode_parity_appended, test_decode_parity_appended_pass_001);
+	tcase_add_test (tc_decode_parity_appended, test_decode_parity_appended_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_decode_parity_appended, test_decode_parity_appended_fail_001, SIGABRT);
 #endif
@@ -313,6 +543,7 @@ make_master_suite (void)
 int
 main (void)
 {
+	pgm_rs_init ();
 	SRunner* sr = srunner_create (make_master_suite ());
 	srunner_add_suite (sr, make_test_suite ());
 	srunner_run_all (sr, CK_ENV);
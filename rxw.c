@@ -66,6 +66,8 @@ static inline uint32_t _pgm_rxw_tg_sqn (pgm_rxw_t*const, const uint32_t);
 static inline uint32_t _pgm_rxw_pkt_sqn (pgm_rxw_t*const, const uint32_t);
 static inline bool _pgm_rxw_is_first_of_tg_sqn (pgm_rxw_t*const, const uint32_t);
 static inline bool _pgm_rxw_is_last_of_tg_sqn (pgm_rxw_t*const, const uint32_t);
+static inline bool _pgm_rxw_is_invalid_var_pktlen (pgm_rxw_t*const restrict, const struct pgm_sk_buff_t*const restrict);
+static inline bool _pgm_rxw_is_invalid_payload_op (pgm_rxw_t*const restrict, const struct pgm_sk_buff_t*const restrict);
 static int _pgm_rxw_insert (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 static int _pgm_rxw_append (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const pgm_time_t);
 static int _pgm_rxw_add_placeholder_range (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t);
@@ -112,6 +114,110 @@ _pgm_rxw_peek (
 	return NULL;
 }
 
+/* returns count of trailing zero bits, n must be non-zero.
+ */
+
+static inline
+unsigned
+_pgm_ctz (
+	uint32_t		n
+	)
+{
+#if (__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)
+	return __builtin_ctz (n);
+#elif defined(_MSC_VER)
+#	include <intrin.h>
+	unsigned long index_;
+	_BitScanForward (&index_, n);
+	return (unsigned)index_;
+#else
+	unsigned count = 0;
+	while (!(n & 1)) {
+		n >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+/* state bitmaps carry one bit per window entry at the same index as pdata,
+ * scans test a word of entries at a time without touching the skbuffs.
+ */
+
+static inline
+void
+_pgm_rxw_bitmap_set (
+	uint32_t* const		bitmap,
+	const uint_fast32_t	index_
+	)
+{
+	bitmap[ index_ >> 5 ] |= (uint32_t)1 << (index_ & 31);
+}
+
+static inline
+void
+_pgm_rxw_bitmap_clear (
+	uint32_t* const		bitmap,
+	const uint_fast32_t	index_
+	)
+{
+	bitmap[ index_ >> 5 ] &= ~((uint32_t)1 << (index_ & 31));
+}
+
+static inline
+bool
+_pgm_rxw_bitmap_test (
+	const pgm_rxw_t* const	window,
+	const uint32_t* const	bitmap,
+	const uint32_t		sequence
+	)
+{
+	const uint_fast32_t index_ = sequence % pgm_rxw_max_length (window);
+	return 0 != (bitmap[ index_ >> 5 ] & ((uint32_t)1 << (index_ & 31)));
+}
+
+/* returns the first sequence of count sequences from sequence with the
+ * bitmap entry set, or sequence + count if none are set.
+ */
+
+static
+uint32_t
+_pgm_rxw_bitmap_find (
+	const pgm_rxw_t* const	window,
+	const uint32_t* const	bitmap,
+	uint32_t		sequence,
+	uint32_t		count
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != bitmap);
+
+	while (count > 0)
+	{
+		const uint_fast32_t index_ = sequence % pgm_rxw_max_length (window);
+		const unsigned shift = index_ & 31;
+		uint32_t span = 32 - shift;
+		uint32_t word;
+
+/* entries are contiguous until the end of pdata or sequence wrap */
+		if (span > pgm_rxw_max_length (window) - index_)
+			span = pgm_rxw_max_length (window) - index_;
+		if (0 != (uint32_t)-sequence && span > (uint32_t)-sequence)
+			span = (uint32_t)-sequence;
+		if (span > count)
+			span = count;
+		word = bitmap[ index_ >> 5 ] >> shift;
+		if (span < 32)
+			word &= ((uint32_t)1 << span) - 1;
+		if (word)
+			return sequence + _pgm_ctz (word);
+		sequence += span;
+		count    -= span;
+	}
+	return sequence;
+}
+
 /* sections of the receive window:
  * 
  *  |     Commit       |   Incoming   |
@@ -202,7 +308,8 @@ pgm_rxw_create (
 /* calculate receive window parameters */
 	pgm_assert (sqns || (secs && max_rte));
 	const unsigned alloc_sqns = sqns ? sqns : (unsigned)( (secs * max_rte) / tpdu_size );
-	window = pgm_malloc0 (sizeof(pgm_rxw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ));
+	const unsigned bitmap_words = (alloc_sqns + 31) / 32;
+	window = pgm_malloc0 (sizeof(pgm_rxw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ) + ( 2 * bitmap_words * sizeof(uint32_t) ));
 
 	window->tsi		= tsi;
 	window->max_tpdu	= tpdu_size;
@@ -228,6 +335,10 @@ pgm_rxw_create (
 /* pointer array */
 	window->alloc = alloc_sqns;
 
+/* state bitmaps follow pointer array */
+	window->missing_bitmap	= (uint32_t*)&window->pdata[ alloc_sqns ];
+	window->data_bitmap	= window->missing_bitmap + bitmap_words;
+
 /* post-conditions */
 	pgm_assert_cmpuint (pgm_rxw_max_length (window), ==, alloc_sqns);
 	pgm_assert_cmpuint (pgm_rxw_length (window), ==, 0);
@@ -268,6 +379,136 @@ pgm_rxw_destroy (
 	pgm_free (window);
 }
 
+/* protocol sanity checks on the PGM header of a data packet independent of
+ * window state.
+ *
+ * side effects:
+ *
+ * 1) sequence number is set in skb from PGM header value.
+ * 2) single fragment APDUs have the fragment option removed.
+ *
+ * returns:
+ * PGM_RXW_OK - header is valid.
+ * PGM_RXW_MALFORMED - corrupted or invalid packet.
+ * PGM_RXW_BOUNDS - trail pointer invalid wrt. sequence.
+ */
+
+static
+int
+_pgm_rxw_verify_header (
+	struct pgm_sk_buff_t* const	skb
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != skb);
+
+	skb->sequence = ntohl (skb->pgm_data->data_sqn);
+
+/* protocol sanity check: tsdu size */
+	if (PGM_UNLIKELY(skb->len != ntohs (skb->pgm_header->pgm_tsdu_length)))
+		return PGM_RXW_MALFORMED;
+
+/* protocol sanity check: valid trail pointer wrt. sequence */
+	if (PGM_UNLIKELY(skb->sequence - ntohl (skb->pgm_data->data_trail) >= ((UINT32_MAX/2)-1)))
+		return PGM_RXW_BOUNDS;
+
+/* verify fragment header for original data, parity packets include a
+ * parity fragment header
+ */
+	if (!(skb->pgm_header->pgm_options & PGM_OPT_PARITY) &&
+	    skb->pgm_opt_fragment)
+	{
+/* protocol sanity check: single fragment APDU */
+		if (PGM_UNLIKELY(ntohl (skb->of_apdu_len) == skb->len))
+			skb->pgm_opt_fragment = NULL;
+
+/* protocol sanity check: minimum APDU length */
+		if (PGM_UNLIKELY(ntohl (skb->of_apdu_len) < skb->len))
+			return PGM_RXW_MALFORMED;
+
+/* protocol sanity check: sequential ordering */
+		if (PGM_UNLIKELY(pgm_uint32_gt (ntohl (skb->of_apdu_first_sqn), skb->sequence)))
+			return PGM_RXW_MALFORMED;
+
+/* protocol sanity check: maximum APDU length */
+		if (PGM_UNLIKELY(ntohl (skb->of_apdu_len) > PGM_MAX_APDU))
+			return PGM_RXW_MALFORMED;
+	}
+	return PGM_RXW_OK;
+}
+
+/* test whether skb would be admitted to the receive window without modifying
+ * the window, such that packets certain to be discarded need not have their
+ * payload checksum verified.  a verdict of PGM_RXW_DUPLICATE or PGM_RXW_BOUNDS
+ * matches the result pgm_rxw_add() would return for the same skb, invalid
+ * headers and packets advancing the advertised trail are left for pgm_rxw_add()
+ * after checksum verification.
+ *
+ * side effects:
+ *
+ * 1) sequence number is set in skb from PGM header value.
+ *
+ * returns:
+ * PGM_RXW_OK - packet may be accepted, verify and pass to pgm_rxw_add().
+ * PGM_RXW_DUPLICATE - re-transmission of previously seen packet.
+ * PGM_RXW_BOUNDS - packet out of window.
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_rxw_admit (
+	pgm_rxw_t*	      const restrict window,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != skb);
+	pgm_assert (pgm_skb_is_valid (skb));
+
+	const int status = _pgm_rxw_verify_header (skb);
+	if (PGM_UNLIKELY(PGM_RXW_MALFORMED == status))
+		return PGM_RXW_OK;
+	if (PGM_UNLIKELY(PGM_RXW_OK != status))
+		return status;
+
+	if (PGM_UNLIKELY(!window->is_defined))
+		return PGM_RXW_OK;
+
+/* an advertised trail ahead of the window must reach the trail update in add
+ * whatever the verdict, such that placeholders behind it are declared lost and
+ * an empty window jumps forward.
+ */
+	if (pgm_uint32_gt (ntohl (skb->pgm_data->data_trail), window->rxw_trail))
+		return PGM_RXW_OK;
+
+/* an advertised trail cannot exceed the sequence and the commit lead only
+ * advances, hence the verdict is unchanged by the trail update in add.
+ */
+	if (skb->pgm_header->pgm_options & PGM_OPT_PARITY)
+	{
+		if (pgm_uint32_lt (_pgm_rxw_tg_sqn (window, skb->sequence), _pgm_rxw_tg_sqn (window, window->commit_lead)))
+			return PGM_RXW_DUPLICATE;
+		return PGM_RXW_OK;
+	}
+
+	if (pgm_uint32_lt (skb->sequence, window->commit_lead)) {
+		if (pgm_uint32_gte (skb->sequence, window->trail))
+			return PGM_RXW_DUPLICATE;
+		else
+			return PGM_RXW_BOUNDS;
+	}
+
+	if (pgm_uint32_lte (skb->sequence, window->lead) &&
+	    _pgm_rxw_bitmap_test (window, window->data_bitmap, skb->sequence) &&
+	    !_pgm_rxw_is_invalid_var_pktlen (window, skb) &&
+	    !_pgm_rxw_is_invalid_payload_op (window, skb))
+	{
+		return PGM_RXW_DUPLICATE;
+	}
+	return PGM_RXW_OK;
+}
+
 /* add skb to receive window.  window has fixed size and will not grow.
  * PGM skbuff data/tail pointers must point to the PGM payload, and hence skb->len
  * is allowed to be zero.
@@ -321,38 +562,9 @@ pgm_rxw_add (
 	pgm_debug ("add (window:%p skb:%p nak_rb_expiry:%" PGM_TIME_FORMAT ")",
 		(const void*)window, (const void*)skb, nak_rb_expiry);
 
-	skb->sequence = ntohl (skb->pgm_data->data_sqn);
-
-/* protocol sanity check: tsdu size */
-	if (PGM_UNLIKELY(skb->len != ntohs (skb->pgm_header->pgm_tsdu_length)))
-		return PGM_RXW_MALFORMED;
-
-/* protocol sanity check: valid trail pointer wrt. sequence */
-	if (PGM_UNLIKELY(skb->sequence - ntohl (skb->pgm_data->data_trail) >= ((UINT32_MAX/2)-1)))
-		return PGM_RXW_BOUNDS;
-
-/* verify fragment header for original data, parity packets include a
- * parity fragment header
- */
-	if (!(skb->pgm_header->pgm_options & PGM_OPT_PARITY) &&
-	    skb->pgm_opt_fragment)
-	{
-/* protocol sanity check: single fragment APDU */
-		if (PGM_UNLIKELY(ntohl (skb->of_apdu_len) == skb->len))
-			skb->pgm_opt_fragment = NULL;
-
-/* protocol sanity check: minimum APDU length */
-		if (PGM_UNLIKELY(ntohl (skb->of_apdu_len) < skb->len))
-			return PGM_RXW_MALFORMED;
-
-/* protocol sanity check: sequential ordering */
-		if (PGM_UNLIKELY(pgm_uint32_gt (ntohl (skb->of_apdu_first_sqn), skb->sequence)))
-			return PGM_RXW_MALFORMED;
-
-/* protocol sanity check: maximum APDU length */
-		if (PGM_UNLIKELY(ntohl (skb->of_apdu_len) > PGM_MAX_APDU))
-			return PGM_RXW_MALFORMED;
-	}
+	status = _pgm_rxw_verify_header (skb);
+	if (PGM_UNLIKELY(PGM_RXW_OK != status))
+		return status;
 
 /* first packet of a session defines the window */
 	if (PGM_UNLIKELY(!window->is_defined))
@@ -549,30 +761,25 @@ _pgm_rxw_update_trail (
 		return;
 	}
 
-/* remove all buffers between commit lead and advertised rxw_trail */
-	for (uint32_t sequence = window->commit_lead;
-	     pgm_uint32_gt (window->rxw_trail, sequence) && pgm_uint32_gte (window->lead, sequence);
-	     sequence++)
+/* remove all buffers between commit lead and advertised rxw_trail, only
+ * placeholders need visiting.
+ */
+	const uint32_t end = pgm_uint32_lte (window->rxw_trail, window->lead) ? window->rxw_trail : window->lead + 1;
+	if (pgm_uint32_lt (window->commit_lead, end))
 	{
-		struct pgm_sk_buff_t* skb;
-		pgm_rxw_state_t* state;
-
-		skb = _pgm_rxw_peek (window, sequence);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
-
-		switch (state->pkt_state) {
-		case PGM_PKT_STATE_HAVE_DATA:
-		case PGM_PKT_STATE_HAVE_PARITY:
-		case PGM_PKT_STATE_LOST_DATA:
-			break;
+		for (uint32_t sequence = _pgm_rxw_bitmap_find (window, window->missing_bitmap, window->commit_lead, end - window->commit_lead);
+		     sequence != end;
+		     sequence = _pgm_rxw_bitmap_find (window, window->missing_bitmap, sequence + 1, end - sequence - 1))
+		{
+			const struct pgm_sk_buff_t* skb;
+			const pgm_rxw_state_t* state;
 
-		case PGM_PKT_STATE_ERROR:
-			pgm_assert_not_reached();
+			skb = _pgm_rxw_peek (window, sequence);
+			pgm_assert (NULL != skb);
+			state = (const pgm_rxw_state_t*)&skb->cb;
 
-		default:
-			pgm_rxw_lost (window, sequence);
-			break;
+			if (PGM_PKT_STATE_LOST_DATA != state->pkt_state)
+				pgm_rxw_lost (window, sequence);
 		}
 	}
 
@@ -587,22 +794,26 @@ PGM_GNUC_INTERNAL
 void
 pgm_rxw_update_fec (
 	pgm_rxw_t* const	window,
-	const uint8_t		rs_k
+	const uint8_t		rs_k,
+	const bool		rs_is_cauchy
 	)
 {
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert_cmpuint (rs_k, >, 1);
 
-	pgm_debug ("pgm_rxw_update_fec (window:%p rs(k):%u)",
-		(void*)window, rs_k);
+	pgm_debug ("pgm_rxw_update_fec (window:%p rs(k):%u rs-cauchy:%s)",
+		(void*)window, rs_k, rs_is_cauchy ? "YES" : "NO");
 
 	if (window->is_fec_available) {
-		if (rs_k == window->rs.k) return;
+		if (rs_k == window->rs.k && rs_is_cauchy == window->rs.is_cauchy) return;
 		pgm_rs_destroy (&window->rs);
 	} else
 		window->is_fec_available = 1;
-	pgm_rs_create (&window->rs, PGM_RS_DEFAULT_N, rs_k);
+	if (rs_is_cauchy)
+		pgm_rs_create_cauchy (&window->rs, PGM_RS_DEFAULT_N, rs_k);
+	else
+		pgm_rs_create (&window->rs, PGM_RS_DEFAULT_N, rs_k);
 	window->tg_sqn_shift = pgm_power2_log2 (rs_k);
 	window->tg_size = window->rs.k;
 }
@@ -638,7 +849,7 @@ _pgm_rxw_add_placeholder (
  */
 	window->data_loss = window->ack_c_p + pgm_fp16mul ((pgm_fp16 (1) - window->ack_c_p), window->data_loss);
 
-	skb			= pgm_alloc_skb (window->max_tpdu);
+	skb			= pgm_skb_pool_alloc (window->skb_pool, window->max_tpdu);
 	state			= (pgm_rxw_state_t*)&skb->cb;
 	skb->tstamp		= now;
 	skb->sequence		= window->lead;
@@ -820,32 +1031,18 @@ _pgm_rxw_find_missing (
 	)
 {
 	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
+	uint32_t sequence;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-	for (uint32_t i = tg_sqn, j = 0; j < window->tg_size; i++, j++)
-	{
-		skb = _pgm_rxw_peek (window, i);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
-		switch (state->pkt_state) {
-		case PGM_PKT_STATE_BACK_OFF:
-		case PGM_PKT_STATE_WAIT_NCF:
-		case PGM_PKT_STATE_WAIT_DATA:
-		case PGM_PKT_STATE_LOST_DATA:
-			return skb;
-
-		case PGM_PKT_STATE_HAVE_DATA:
-		case PGM_PKT_STATE_HAVE_PARITY:
-			break;
-
-		default: pgm_assert_not_reached(); break;
-		}
-	}
+	sequence = _pgm_rxw_bitmap_find (window, window->missing_bitmap, tg_sqn, window->tg_size);
+	if (sequence == tg_sqn + window->tg_size)
+		return NULL;
 
-	return NULL;
+	skb = _pgm_rxw_peek (window, sequence);
+	pgm_assert (NULL != skb);
+	return skb;
 }
 
 /* returns TRUE if skb is a parity packet with packet length not
@@ -1145,7 +1342,7 @@ _pgm_rxw_append (
 	if (PGM_UNLIKELY(skb->pgm_opt_fragment &&
 	    _pgm_rxw_is_apdu_lost (window, skb)))
 	{
-		struct pgm_sk_buff_t* lost_skb	= pgm_alloc_skb (window->max_tpdu);
+		struct pgm_sk_buff_t* lost_skb	= pgm_skb_pool_alloc (window->skb_pool, window->max_tpdu);
 		lost_skb->tstamp		= now;
 		lost_skb->sequence		= skb->sequence;
 
@@ -1458,7 +1655,7 @@ _pgm_rxw_reconstruct (
 		case PGM_PKT_STATE_WAIT_NCF:
 		case PGM_PKT_STATE_WAIT_DATA:
 		case PGM_PKT_STATE_LOST_DATA:
-			skb = pgm_alloc_skb (window->max_tpdu);
+			skb = pgm_skb_pool_alloc (window->skb_pool, window->max_tpdu);
 			pgm_skb_reserve (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
 			skb->pgm_header = skb->head;
 			skb->pgm_data = (void*)( skb->pgm_header + 1 );
@@ -1595,7 +1792,7 @@ _pgm_rxw_is_apdu_complete (
 		pgm_rxw_state_t* state = (pgm_rxw_state_t*)&skb->cb;
 
 		if (!check_parity &&
-		    PGM_PKT_STATE_HAVE_DATA != state->pkt_state)
+		    !_pgm_rxw_bitmap_test (window, window->data_bitmap, sequence))
 		{
 			if (window->is_fec_available &&
 			    !_pgm_rxw_is_tg_sqn_lost (window, tg_sqn) )
@@ -1626,8 +1823,7 @@ _pgm_rxw_is_apdu_complete (
 		else
 		{
 /* single packet APDU, already complete */
-			if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state &&
-			    !skb->pgm_opt_fragment)
+			if (!skb->pgm_opt_fragment)
 				return TRUE;
 
 /* protocol sanity check: matching first sequence reference */
@@ -1793,6 +1989,7 @@ _pgm_rxw_state (
 	pgm_assert (NULL != skb);
 
 	state = (pgm_rxw_state_t*)&skb->cb;
+	const uint_fast32_t index_ = skb->sequence % pgm_rxw_max_length (window);
 
 /* remove current state */
 	if (PGM_PKT_STATE_ERROR != state->pkt_state)
@@ -1801,17 +1998,21 @@ _pgm_rxw_state (
 	switch (new_pkt_state) {
 	case PGM_PKT_STATE_BACK_OFF:
 		pgm_queue_push_head_link (&window->nak_backoff_queue, (pgm_list_t*)skb);
+		_pgm_rxw_bitmap_set (window->missing_bitmap, index_);
 		break;
 
 	case PGM_PKT_STATE_WAIT_NCF:
 		pgm_queue_push_head_link (&window->wait_ncf_queue, (pgm_list_t*)skb);
+		_pgm_rxw_bitmap_set (window->missing_bitmap, index_);
 		break;
 
 	case PGM_PKT_STATE_WAIT_DATA:
 		pgm_queue_push_head_link (&window->wait_data_queue, (pgm_list_t*)skb);
+		_pgm_rxw_bitmap_set (window->missing_bitmap, index_);
 		break;
 
 	case PGM_PKT_STATE_HAVE_DATA:
+		_pgm_rxw_bitmap_set (window->data_bitmap, index_);
 		window->fragment_count++;
 		pgm_assert_cmpuint (window->fragment_count, <=, pgm_rxw_length (window));
 		break;
@@ -1827,6 +2028,7 @@ _pgm_rxw_state (
 		break;
 
 	case PGM_PKT_STATE_LOST_DATA:
+		_pgm_rxw_bitmap_set (window->missing_bitmap, index_);
 		window->lost_count++;
 		window->cumulative_losses++;
 		window->has_event = 1;
@@ -1867,6 +2069,7 @@ _pgm_rxw_unlink (
 {
 	pgm_rxw_state_t* state;
 	pgm_queue_t* queue;
+	uint_fast32_t index_;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
@@ -1918,6 +2121,9 @@ unlink_queue:
 	default: pgm_assert_not_reached(); break;
 	}
 
+	index_ = skb->sequence % pgm_rxw_max_length (window);
+	_pgm_rxw_bitmap_clear (window->missing_bitmap, index_);
+	_pgm_rxw_bitmap_clear (window->data_bitmap, index_);
 	state->pkt_state = PGM_PKT_STATE_ERROR;
 	pgm_assert (((pgm_list_t*)skb)->next == NULL);
 	pgm_assert (((pgm_list_t*)skb)->prev == NULL);
@@ -2114,7 +2320,7 @@ _pgm_rxw_recovery_append (
  */
 	window->data_loss = window->ack_c_p + pgm_fp16mul (pgm_fp16 (1) - window->ack_c_p, window->data_loss);
 
-	skb			= pgm_alloc_skb (window->max_tpdu);
+	skb			= pgm_skb_pool_alloc (window->skb_pool, window->max_tpdu);
 	state			= (pgm_rxw_state_t*)&skb->cb;
 	skb->tstamp		= now;
 	skb->sequence		= window->lead;
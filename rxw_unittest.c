@@ -37,6 +37,7 @@
 #define pgm_histogram_add		mock_pgm_histogram_add
 #define pgm_time_now			mock_pgm_time_now
 #define pgm_rs_create			mock_pgm_rs_create
+#define pgm_rs_create_cauchy		mock_pgm_rs_create
 #define pgm_rs_destroy			mock_pgm_rs_destroy
 #define pgm_rs_decode_parity_appended	mock_pgm_rs_decode_parity_appended
 #define pgm_histogram_init		mock_pgm_histogram_init
@@ -468,6 +469,105 @@ START_TEST (test_add_fail_004)
 }
 END_TEST
 
+/* target:
+ *	int
+ *	pgm_rxw_admit (
+ *		pgm_rxw_t* const		window,
+ *		struct pgm_sk_buff_t* const	skb
+ *		)
+ */
+
+/* verdict matches add without modifying window */
+START_TEST (test_admit_pass_001)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* #1 undefined window */
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_OK == pgm_rxw_admit (window, skb), "admit not ok");
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+/* #2 with jump */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (2);
+	fail_unless (PGM_RXW_OK == pgm_rxw_admit (window, skb), "admit not ok");
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+/* #3 repeat sequence */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_DUPLICATE == pgm_rxw_admit (window, skb), "admit not duplicate");
+	fail_unless (PGM_RXW_DUPLICATE == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not duplicate");
+/* #4 fill in placeholder */
+	skb->pgm_data->data_sqn = g_htonl (1);
+	fail_unless (PGM_RXW_OK == pgm_rxw_admit (window, skb), "admit not ok");
+/* #5 trail ahead of sequence */
+	skb->pgm_data->data_sqn = g_htonl (1);
+	skb->pgm_data->data_trail = g_htonl (2);
+	fail_unless (PGM_RXW_BOUNDS == pgm_rxw_admit (window, skb), "admit not bounds");
+/* #6 malformed left for add */
+	skb->pgm_data->data_trail = g_htonl (0);
+	skb->pgm_header->pgm_tsdu_length = g_htons (1);
+	fail_unless (PGM_RXW_OK == pgm_rxw_admit (window, skb), "admit not ok");
+	fail_unless (PGM_RXW_MALFORMED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not malformed");
+	fail_unless (3 == pgm_rxw_length (window), "length not 3");
+	pgm_free_skb (skb);
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* duplicate advancing the advertised trail is left for add */
+START_TEST (test_admit_pass_002)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (3);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+	fail_unless (window->is_constrained, "window not constrained");
+/* repair of #3 advertising trail 2 */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_header->pgm_type = PGM_RDATA;
+	skb->pgm_data->data_sqn = g_htonl (3);
+	skb->pgm_data->data_trail = g_htonl (2);
+	fail_unless (PGM_RXW_OK == pgm_rxw_admit (window, skb), "admit not ok");
+	fail_unless (PGM_RXW_DUPLICATE == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not duplicate");
+	fail_unless (2 == window->rxw_trail, "rxw_trail not advanced");
+	fail_unless (!window->is_constrained, "window constrained");
+	fail_unless (1 == window->cumulative_losses, "placeholder not lost");
+/* trail no longer ahead */
+	fail_unless (PGM_RXW_DUPLICATE == pgm_rxw_admit (window, skb), "admit not duplicate");
+	pgm_free_skb (skb);
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+START_TEST (test_admit_fail_001)
+{
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	int retval = pgm_rxw_admit (NULL, skb);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	struct pgm_sk_buff_t*
  *	pgm_rxw_peek (
@@ -1201,6 +1301,46 @@ START_TEST (test_update_pass_001)
 }
 END_TEST
 
+/* trail advance across pdata wrap marks only placeholders lost */
+START_TEST (test_update_pass_002)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* #1 at 90 */
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (90);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+/* #2 at 130 with jump */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (130);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+/* #3 at 95 */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (95);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+	fail_unless (0 == pgm_rxw_update (window, 130, 120, now, nak_rb_expiry), "update failed");
+	for (uint32_t i = 91; i <= 129; i++) {
+		skb = pgm_rxw_peek (window, i);
+		fail_if (NULL == skb, "peek failed");
+		const pgm_rxw_state_t* state = (pgm_rxw_state_t*)&skb->cb;
+		if (95 == i)
+			fail_unless (PGM_PKT_STATE_HAVE_DATA == state->pkt_state, "state not have-data");
+		else if (i < 120)
+			fail_unless (PGM_PKT_STATE_LOST_DATA == state->pkt_state, "state not lost-data");
+		else
+			fail_unless (PGM_PKT_STATE_BACK_OFF == state->pkt_state, "state not back-off");
+	}
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
 START_TEST (test_update_fail_001)
 {
 	guint count = pgm_rxw_update (NULL, 0, 0, 0, 0);
@@ -1513,6 +1653,14 @@ make_basic_test_suite (void)
 	tcase_add_test_raise_signal (tc_add, test_add_fail_003, SIGABRT);
 #endif
 
+	TCase* tc_admit = tcase_create ("admit");
+	suite_add_tcase (s, tc_admit);
+	tcase_add_test (tc_admit, test_admit_pass_001);
+	tcase_add_test (tc_admit, test_admit_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_admit, test_admit_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_peek = tcase_create ("peek");
 	suite_add_tcase (s, tc_peek);
 	tcase_add_test (tc_peek, test_peek_pass_001);
@@ -1594,6 +1742,7 @@ make_basic_test_suite (void)
 	TCase* tc_update = tcase_create ("update");
 	suite_add_tcase (s, tc_update);
 	tcase_add_test (tc_update, test_update_pass_001);
+	tcase_add_test (tc_update, test_update_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_update, test_update_fail_001, SIGABRT);
 #endif
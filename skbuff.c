@@ -22,10 +22,16 @@
 #ifdef HAVE_CONFIG_H
 #	include <config.h>
 #endif
+#include <impl/i18n.h>
 #include <impl/framework.h>
+#include <impl/mem.h>
 #include "pgm/skbuff.h"
 
 
+/* slab stride alignment within a mapped region */
+#define SKB_POOL_ALIGN		64
+
+
 void
 pgm_skb_over_panic (
 	const struct pgm_sk_buff_t*const skb,
@@ -115,4 +121,214 @@ pgm_skb_is_valid (
 }
 #endif /* SKB_DEBUG */
 
+/* create a pool of fixed size socket buffers, slabs are taken from the heap
+ * on demand and retained on release up to max_depth.
+ *
+ * with a page_size all max_depth slabs are carved up front from one
+ * pre-faulted mapping on huge pages, the heap only serves overflow.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_skb_pool_t*
+pgm_skb_pool_create (
+	const uint16_t		size,
+	const unsigned		max_depth,
+	const size_t		page_size,
+	const bool		use_mlock
+	)
+{
+	pgm_skb_pool_t* pool;
+	unsigned i;
+
+/* pre-conditions */
+	pgm_assert (size > 0);
+	pgm_assert (max_depth > 0);
+
+	pool = pgm_new0 (pgm_skb_pool_t, 1);
+	pgm_spinlock_init (&pool->lock);
+	pool->size	= size;
+	pool->max_depth	= max_depth;
+
+	if (page_size) {
+		const size_t stride = (size + sizeof(struct pgm_sk_buff_t) + SKB_POOL_ALIGN - 1) & ~(size_t)(SKB_POOL_ALIGN - 1);
+		pool->region_len = stride * max_depth;
+		pool->region = pgm_mem_map (&pool->region_len, page_size, use_mlock);
+		if (NULL == pool->region) {
+			pgm_trace (PGM_LOG_ROLE_MEMORY,_("Mapping socket buffer pool of %" PRIzu " bytes failed."), stride * max_depth);
+			pool->region_len = 0;
+			return pool;
+		}
+		for (i = max_depth; i > 0; i--) {
+			struct pgm_sk_buff_t* skb = (struct pgm_sk_buff_t*)(pool->region + (i - 1) * stride);
+			skb->link_.data = pool->free_list;
+			pool->free_list = skb;
+		}
+		pool->depth = max_depth;
+	}
+	return pool;
+}
+
+static inline
+bool
+_pgm_skb_pool_is_slab (
+	const pgm_skb_pool_t*const	  pool,
+	const struct pgm_sk_buff_t*const  skb
+	)
+{
+	return NULL != pool->region &&
+	       (const char*)skb >= pool->region &&
+	       (const char*)skb <  pool->region + pool->region_len;
+}
+
+static
+void
+_pgm_skb_pool_free (
+	pgm_skb_pool_t*		pool
+	)
+{
+	if (pool->region)
+		pgm_mem_unmap (pool->region, pool->region_len);
+	pgm_spinlock_free (&pool->lock);
+	pgm_free (pool);
+}
+
+/* release all cached slabs, the pool itself lingers until every slab still
+ * held by an application or the kernel is returned.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_skb_pool_destroy (
+	pgm_skb_pool_t*		pool
+	)
+{
+	struct pgm_sk_buff_t* skb;
+	bool is_unused;
+
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+
+	pgm_spinlock_lock (&pool->lock);
+	pool->is_destroyed = TRUE;
+	skb = pool->free_list;
+	pool->free_list = NULL;
+	pool->depth = 0;
+	is_unused = (0 == pool->outstanding);
+	pgm_spinlock_unlock (&pool->lock);
+
+	while (skb) {
+		struct pgm_sk_buff_t* next = skb->link_.data;
+		if (!_pgm_skb_pool_is_slab (pool, skb))
+			pgm_free (skb);
+		skb = next;
+	}
+	if (is_unused)
+		_pgm_skb_pool_free (pool);
+}
+
+/* allocate a socket buffer of size bytes, from pool when provided otherwise
+ * directly from the heap as pgm_alloc_skb().
+ */
+
+PGM_GNUC_INTERNAL
+struct pgm_sk_buff_t*
+pgm_skb_pool_alloc (
+	pgm_skb_pool_t*const	pool,
+	const uint16_t		size
+	)
+{
+	struct pgm_sk_buff_t* skb;
+
+	if (NULL == pool)
+		return pgm_alloc_skb (size);
+
+	pgm_assert (size <= pool->size);
+
+	pgm_spinlock_lock (&pool->lock);
+	skb = pool->free_list;
+	if (PGM_LIKELY(NULL != skb)) {
+		pool->free_list = skb->link_.data;
+		pool->depth--;
+		pool->hits++;
+	} else
+		pool->misses++;
+	pool->outstanding++;
+	pgm_spinlock_unlock (&pool->lock);
+
+	if (PGM_UNLIKELY(NULL == skb))
+		skb = (struct pgm_sk_buff_t*)pgm_malloc (pool->size + sizeof(struct pgm_sk_buff_t));
+	if (PGM_UNLIKELY(pgm_mem_gc_friendly)) {
+		memset (skb, 0, pool->size + sizeof(struct pgm_sk_buff_t));
+		skb->zero_padded = 1;
+	} else {
+		memset (skb, 0, sizeof(struct pgm_sk_buff_t));
+	}
+	skb->truesize = pool->size + sizeof(struct pgm_sk_buff_t);
+	pgm_atomic_write32 (&skb->users, 1);
+	skb->pool = pool;
+	skb->head = skb + 1;
+	skb->data = skb->tail = skb->head;
+	skb->end  = (char*)skb->data + pool->size;
+	return skb;
+}
+
+/* return a socket buffer to its pool on final pgm_free_skb().
+ */
+
+void
+pgm_skb_pool_release (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	pgm_skb_pool_t* pool;
+	bool is_slab, is_unused = FALSE, is_cached = FALSE;
+
+/* pre-conditions */
+	pgm_assert (NULL != skb);
+	pgm_assert (NULL != skb->pool);
+
+	pool = skb->pool;
+	is_slab = _pgm_skb_pool_is_slab (pool, skb);
+	pgm_spinlock_lock (&pool->lock);
+	pool->outstanding--;
+	if (PGM_LIKELY(!pool->is_destroyed)) {
+/* a mapped region holds max_depth slabs, overflow always returns to heap */
+		if (is_slab || (NULL == pool->region && pool->depth < pool->max_depth)) {
+			skb->link_.data = pool->free_list;
+			pool->free_list = skb;
+			pool->depth++;
+			is_cached = TRUE;
+		}
+	} else
+		is_unused = (0 == pool->outstanding);
+	pgm_spinlock_unlock (&pool->lock);
+
+	if (!is_cached && !is_slab)
+		pgm_free (skb);
+	if (is_unused)
+		_pgm_skb_pool_free (pool);
+}
+
+/* snapshot of pool counters for PGM_SKB_POOL_STATS.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_skb_pool_stats (
+	pgm_skb_pool_t*const restrict		  pool,
+	struct pgm_skbpoolinfo_t*const restrict	  info
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+	pgm_assert (NULL != info);
+
+	pgm_spinlock_lock (&pool->lock);
+	info->depth	= pool->depth;
+	info->max_depth	= pool->max_depth;
+	info->hits	= pool->hits;
+	info->misses	= pool->misses;
+	pgm_spinlock_unlock (&pool->lock);
+}
+
 /* eof */
@@ -27,6 +27,9 @@
 #	include <sys/socket.h>
 #	include <netdb.h>
 #endif
+#ifdef HAVE_LINUX_FILTER_H
+#	include <linux/filter.h>
+#endif
 #include <impl/framework.h>
 
 
@@ -491,6 +494,109 @@ pgm_sockaddr_pktinfo (
 	return retval;
 }
 
+/* Discard packets of other PGM sessions, those where neither the source nor
+ * destination port is the data-destination port, before they are queued to
+ * the socket.  dport is in host byte order.
+ *
+ * With shard_count > 1 only packets of transport sessions hashing to
+ * shard_index are accepted, so that sockets of one session bound in
+ * separate threads each own a disjoint set of peers.  The hash covers the
+ * GSI and the source port exclusive-or destination port, which is the same
+ * for downstream, upstream and peer-to-peer packets of one TSI.
+ *
+ * If no error occurs, pgm_sockaddr_session_filter returns zero.  Otherwise,
+ * a value of SOCKET_ERROR is returned, and a specific error code can be
+ * retrieved by calling pgm_get_last_sock_error().
+ *
+ * Linux:socket(7) "SO_ATTACH_FILTER" classic BPF, the program sees the packet
+ * from the IPv4 header on raw IPv4 sockets, from the PGM header on raw IPv6
+ * sockets, and from the UDP header on UDP sockets.
+ *
+ * Other platforms fail with ENOPROTOOPT.
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_sockaddr_session_filter (
+	const SOCKET		s,
+	const sa_family_t	sa_family,
+	const bool		is_udp_encap,
+	const uint16_t		dport,
+	const uint16_t		shard_count,
+	const uint16_t		shard_index
+	)
+{
+#if defined(HAVE_LINUX_FILTER_H) && defined(SO_ATTACH_FILTER)
+	struct sock_filter code[] = {
+/* X = offset of PGM header */
+		BPF_STMT(BPF_LDX|BPF_IMM, 0),
+/* pgm_sport */
+		BPF_STMT(BPF_LD|BPF_H|BPF_IND, 0),
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, dport, 3, 0),
+/* pgm_dport */
+		BPF_STMT(BPF_LD|BPF_H|BPF_IND, 2),
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, dport, 1, 0),
+		BPF_STMT(BPF_RET|BPF_K, 0),
+/* accept session, or with sharding M[0] = pgm_sport */
+		BPF_STMT(BPF_RET|BPF_K, 0xffffffff),
+		BPF_STMT(BPF_ST, 0),
+/* M[1] = pgm_dport, M[2] = pgm_gsi[4..5], A = pgm_gsi[0..3] */
+		BPF_STMT(BPF_LD|BPF_H|BPF_IND, 2),
+		BPF_STMT(BPF_ST, 1),
+		BPF_STMT(BPF_LD|BPF_H|BPF_IND, 12),
+		BPF_STMT(BPF_ST, 2),
+		BPF_STMT(BPF_LD|BPF_W|BPF_IND, 8),
+/* multiplicative hash */
+		BPF_STMT(BPF_LDX|BPF_MEM, 0),
+		BPF_STMT(BPF_ALU|BPF_XOR|BPF_X, 0),
+		BPF_STMT(BPF_LDX|BPF_MEM, 1),
+		BPF_STMT(BPF_ALU|BPF_XOR|BPF_X, 0),
+		BPF_STMT(BPF_ALU|BPF_MUL|BPF_K, 0x9e3779b1),
+		BPF_STMT(BPF_LDX|BPF_MEM, 2),
+		BPF_STMT(BPF_ALU|BPF_XOR|BPF_X, 0),
+		BPF_STMT(BPF_ALU|BPF_MUL|BPF_K, 0x9e3779b1),
+/* shard = ((hash >> 16) * shard_count) >> 16 */
+		BPF_STMT(BPF_ALU|BPF_RSH|BPF_K, 16),
+		BPF_STMT(BPF_ALU|BPF_MUL|BPF_K, shard_count),
+		BPF_STMT(BPF_ALU|BPF_RSH|BPF_K, 16),
+		BPF_JUMP(BPF_JMP|BPF_JEQ|BPF_K, shard_index, 0, 1),
+		BPF_STMT(BPF_RET|BPF_K, 0xffffffff),
+		BPF_STMT(BPF_RET|BPF_K, 0)
+	};
+	struct sock_fprog prog;
+
+	if (is_udp_encap) {
+		const struct sock_filter ldx = BPF_STMT(BPF_LDX|BPF_IMM, 8 /* sizeof(struct pgm_udphdr) */);
+		code[0] = ldx;
+	} else if (AF_INET == sa_family) {
+		const struct sock_filter ldx = BPF_STMT(BPF_LDX|BPF_B|BPF_MSH, 0);	/* 4 * (ip_hl) */
+		code[0] = ldx;
+	}
+	if (shard_count > 1) {
+		const struct sock_filter ld = BPF_STMT(BPF_LD|BPF_H|BPF_IND, 0);
+		code[6] = ld;
+		prog.len = sizeof(code) / sizeof(code[0]);
+	} else {
+		prog.len = 7;
+	}
+	prog.filter = code;
+	return setsockopt (s, SOL_SOCKET, SO_ATTACH_FILTER, (const char*)&prog, sizeof(prog));
+#else
+	(void)s;
+	(void)sa_family;
+	(void)is_udp_encap;
+	(void)dport;
+	(void)shard_count;
+	(void)shard_index;
+#	ifndef _WIN32
+	errno = ENOPROTOOPT;
+#	else
+	WSASetLastError (WSAENOPROTOOPT);
+#	endif
+	return SOCKET_ERROR;
+#endif
+}
+
 /* Set IP Router Alert option for all outgoing packets.
  *
  * If no error occurs, pgm_sockaddr_router_alert returns zero.  Otherwise, a
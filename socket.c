@@ -30,6 +30,9 @@
 #ifdef HAVE_EPOLL_CTL
 #	include <sys/epoll.h>
 #endif
+#ifndef _WIN32
+#	include <netinet/udp.h>		/* UDP_GRO */
+#endif
 #include <stdio.h>
 #include <impl/i18n.h>
 #include <impl/framework.h>
@@ -37,6 +40,7 @@
 #include <impl/receiver.h>
 #include <impl/source.h>
 #include <impl/timer.h>
+#include <impl/uring.h>
 
 
 //#define SOCK_DEBUG
@@ -51,6 +55,7 @@ pgm_slist_t* pgm_sock_list = NULL;
 static const char* pgm_family_string (const int) PGM_GNUC_CONST;
 static const char* pgm_sock_type_string (const int) PGM_GNUC_CONST;
 static const char* pgm_protocol_string (const int) PGM_GNUC_CONST;
+static SOCKET pgm_recv_event_socket (const pgm_sock_t*const);
 
 
 size_t
@@ -284,6 +289,11 @@ pgm_close (
 			sock->peers_list = next;
 		} while (sock->peers_list);
 	}
+	if (sock->peers_heap) {
+		pgm_free (sock->peers_heap);
+		sock->peers_heap = NULL;
+		sock->peers_heap_len = sock->peers_heap_size = 0;
+	}
 
 	if (sock->window) {
 		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Destroying transmit window."));
@@ -307,6 +317,39 @@ pgm_close (
 		pgm_free_skb (sock->rx_buffer);
 		sock->rx_buffer = NULL;
 	}
+#ifdef HAVE_LINUX_IO_URING_H
+	if (sock->rx_uring) {
+		pgm_debug ("destroying io_uring receive ring.");
+		pgm_uring_destroy (sock->rx_uring);
+		sock->rx_uring = NULL;
+	}
+#endif
+	if (sock->rx_ring) {
+		pgm_debug ("freeing receive ring.");
+		for (unsigned i = 0; i < sock->rx_ring_size; i++)
+			pgm_free_skb (sock->rx_ring[i].skb);
+		pgm_free (sock->rx_ring);
+		sock->rx_ring = NULL;
+	}
+	if (sock->rx_gro_buffer) {
+		pgm_free (sock->rx_gro_buffer);
+		sock->rx_gro_buffer = NULL;
+	}
+	if (sock->zc_ring) {
+		pgm_debug ("freeing zero-copy completion ring.");
+		for (unsigned i = 0; i < sock->zc_len; i++) {
+			struct pgm_sk_buff_t* skb = sock->zc_ring[ (sock->zc_head + i) % PGM_MAX_ZEROCOPY ].skb;
+			if (NULL != skb)
+				pgm_free_skb (skb);
+		}
+		pgm_free (sock->zc_ring);
+		sock->zc_ring = NULL;
+	}
+	if (sock->skb_pool) {
+		pgm_debug ("destroying socket buffer pool.");
+		pgm_skb_pool_destroy (sock->skb_pool);
+		sock->skb_pool = NULL;
+	}
 	pgm_debug ("destroying notification channels.");
 	if (sock->can_send_data) {
 		if (sock->use_pgmcc) {
@@ -692,7 +735,7 @@ pgm_getsockopt (
 			break;
 		if (PGM_UNLIKELY(*optlen != sizeof (SOCKET)))
 			break;
-		*(SOCKET*restrict)optval = sock->recv_sock;
+		*(SOCKET*restrict)optval = pgm_recv_event_socket (sock);
 		status = TRUE;
 		break;
 
@@ -1017,6 +1060,118 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_SEND_BATCH:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_send_batch ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_RECV_BATCH:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->rx_ring_size;
+		status = TRUE;
+		break;
+
+	case PGM_UDP_GSO:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_udp_gso ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_UDP_GRO:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_udp_gro ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_ZEROCOPY:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_zerocopy ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_IO_URING:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_io_uring ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_RECV_TIMESTAMP:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_kernel_tstamp ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_FEC_CAUCHY:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_cauchy_parity ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_UDP_CSUM_OFFLOAD:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_checksum_offload ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_SESSION_FILTER:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_session_filter ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_RECV_SHARD:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_shardinfo_t)))
+			break;
+		{
+			struct pgm_shardinfo_t*restrict shardinfo = optval;
+			shardinfo->shard_count = sock->recv_shard_count;
+			shardinfo->shard_index = sock->recv_shard_index;
+		}
+		status = TRUE;
+		break;
+
+	case PGM_SKB_POOL:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->skb_pool_depth;
+		status = TRUE;
+		break;
+
+	case PGM_SKB_POOL_STATS:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_skbpoolinfo_t)))
+			break;
+		if (NULL != sock->skb_pool)
+			pgm_skb_pool_stats (sock->skb_pool, optval);
+		else
+			memset (optval, 0, sizeof (struct pgm_skbpoolinfo_t));
+		status = TRUE;
+		break;
+
+	case PGM_HUGEPAGES:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->hugepage_size;
+		status = TRUE;
+		break;
+
+	case PGM_MLOCK:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_mlock ? 1 : 0;
+		status = TRUE;
+		break;
+
 	case PGM_SEND_GROUP:
 		if (PGM_UNLIKELY(*optlen != sizeof (struct group_req)))
 			break;
@@ -1555,6 +1710,207 @@ pgm_setsockopt (
 		status = TRUE;
 		break;
 
+/* send fragments of one APDU with a single batched system call.
+ */
+	case PGM_SEND_BATCH:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_send_batch = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* read up to n packets with a single batched system call, 0 or 1 to disable.
+ * 0 <= n <= PGM_MAX_RECV_BATCH, the receive ring is allocated on bind.
+ */
+	case PGM_RECV_BATCH:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval > PGM_MAX_RECV_BATCH))
+			break;
+		sock->rx_ring_size = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* send fragments of one APDU as a single UDP segmentation offload buffer,
+ * only for UDP encapsulation.
+ */
+	case PGM_UDP_GSO:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(IPPROTO_UDP != sock->protocol))
+			break;
+		sock->use_udp_gso = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* receive coalesced UDP generic receive offload buffers split into one
+ * packet per TPDU, only for UDP encapsulation.  enabled on bind.
+ */
+	case PGM_UDP_GRO:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(IPPROTO_UDP != sock->protocol))
+			break;
+		sock->use_udp_gro = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* send fragments of one APDU with MSG_ZEROCOPY, only for UDP encapsulation.
+ * enabled on bind.
+ */
+	case PGM_ZEROCOPY:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(IPPROTO_UDP != sock->protocol))
+			break;
+		sock->use_zerocopy = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* keep one asynchronous io_uring receive in flight per receive ring slot.
+ * enabled on bind.
+ */
+	case PGM_IO_URING:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_io_uring = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* stamp incoming packets with the kernel receive time instead of reading the
+ * clock on dequeue.  enabled on bind.
+ */
+	case PGM_RECV_TIMESTAMP:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_kernel_tstamp = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* encode parity with a Cauchy rather than Vandermonde generator matrix,
+ * advertised to receivers in OPT_PARITY_PRM.  applies with PGM_USE_FEC.
+ */
+	case PGM_FEC_CAUCHY:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_cauchy_parity = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* trust the UDP checksum validated by the kernel or NIC: data is sent with
+ * pgm_checksum = 0 and received without software verification, so both
+ * source and receivers must enable it, a receiver without it warns once on
+ * discarding such data.  only for UDP encapsulation.
+ */
+	case PGM_UDP_CSUM_OFFLOAD:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(IPPROTO_UDP != sock->protocol))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_checksum_offload = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* drop packets of other PGM sessions in the kernel before they are queued to
+ * the socket, such packets are then absent from the receive statistics.
+ * Linux only, bind fails on other platforms.
+ */
+	case PGM_SESSION_FILTER:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_session_filter = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* receive only transport sessions whose TSI hashes to shard_index of
+ * shard_count, so that one receive-only socket per thread splits the peers
+ * of a session between threads, each with its own receive windows and
+ * timers.  applied with the session filter on bind.
+ */
+	case PGM_RECV_SHARD:
+		if (PGM_UNLIKELY(optlen != sizeof (struct pgm_shardinfo_t)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		{
+			const struct pgm_shardinfo_t* shardinfo = optval;
+			if (PGM_UNLIKELY(0 == shardinfo->shard_count))
+				break;
+			if (PGM_UNLIKELY(shardinfo->shard_index >= shardinfo->shard_count))
+				break;
+			sock->recv_shard_count = shardinfo->shard_count;
+			sock->recv_shard_index = shardinfo->shard_index;
+		}
+		status = TRUE;
+		break;
+
+/* maximum count of max_tpdu socket buffers retained per socket for reuse
+ * instead of returning them to the heap, 0 to disable.  the pool is created
+ * on bind.
+ */
+	case PGM_SKB_POOL:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		{
+			const int depth = *(const int*)optval;
+			if (PGM_UNLIKELY(depth < 0))
+				break;
+			sock->skb_pool_depth = depth;
+		}
+		status = TRUE;
+		break;
+
+/* back the transmit window and socket buffer pool with huge pages of the
+ * given size in bytes, 2MB or 1GB, pre-faulted on bind.  normal pages are
+ * used when none are reserved.  0 to disable.
+ */
+	case PGM_HUGEPAGES:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		{
+			const int page_size = *(const int*)optval;
+			if (PGM_UNLIKELY(0 != page_size &&
+					 (2 * 1024 * 1024) != page_size &&
+					 (1024 * 1024 * 1024) != page_size))
+				break;
+			sock->hugepage_size = page_size;
+		}
+		status = TRUE;
+		break;
+
+/* lock huge page backed memory into RAM, failure is not fatal.
+ */
+	case PGM_MLOCK:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_mlock = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
 /* sending group, singular.  note that the address is only stored and used
  * later in sendto() calls, this routine only considers the interface.
  */
@@ -2112,7 +2468,11 @@ pgm_bind3 (
 							0,			/* TXW_MAX_RTE */
 							sock->use_ondemand_parity || sock->use_proactive_parity,
 							sock->rs_n,
-							sock->rs_k) :
+							sock->rs_k,
+							sock->rs_proactive_h,
+							sock->use_cauchy_parity,
+							sock->hugepage_size,
+							sock->use_mlock) :
 					pgm_txw_create (&sock->tsi,
 							sock->max_tpdu,		/* MAX_TPDU */
 							0,			/* TXW_SQNS */
@@ -2120,7 +2480,11 @@ pgm_bind3 (
 							sock->txw_max_rte,	/* TXW_MAX_RTE */
 							sock->use_ondemand_parity || sock->use_proactive_parity,
 							sock->rs_n,
-							sock->rs_k);
+							sock->rs_k,
+							sock->rs_proactive_h,
+							sock->use_cauchy_parity,
+							sock->hugepage_size,
+							sock->use_mlock);
 		pgm_assert (NULL != sock->window);
 	}
 
@@ -2218,6 +2582,36 @@ pgm_bind3 (
 		pgm_debug ("bind succeeded on recv_gsr[0] interface %s", s);
 	}
 
+/* drop packets of other sessions before they are queued to the socket when
+ * requested, a sending socket must see NAKs for its own TSI so is never sharded.
+ */
+	const uint16_t shard_count = sock->can_send_data ? 1 : sock->recv_shard_count;
+	if (sock->use_session_filter || shard_count > 1)
+	{
+		if (SOCKET_ERROR == pgm_sockaddr_session_filter (sock->recv_sock,
+								 sock->family,
+								 IPPROTO_UDP == sock->protocol,
+								 ntohs (sock->dport),
+								 shard_count,
+								 sock->recv_shard_index))
+		{
+			const int save_errno = pgm_get_last_sock_error();
+			char errbuf[1024];
+			pgm_set_error (error,
+				       PGM_ERROR_DOMAIN_SOCKET,
+				       pgm_error_from_sock_errno (save_errno),
+				       _("Attaching session packet filter: %s"),
+				       pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			pgm_rwlock_writer_unlock (&sock->lock);
+			return FALSE;
+		}
+		if (shard_count > 1)
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Receiving shard %u of %u"),
+				   (unsigned)sock->recv_shard_index, (unsigned)shard_count);
+		else
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Session packet filter attached."));
+	}
+
 /* keep a copy of the original address source to re-use for router alert bind */
 	memset (&send_addr, 0, sizeof(send_addr));
 
@@ -2338,8 +2732,108 @@ pgm_bind3 (
 		}
 	}
 
+#ifdef USE_ZEROCOPY
+	if (sock->use_zerocopy) {
+		const int v = 1;
+		if (SOCKET_ERROR == setsockopt (sock->send_sock, SOL_SOCKET, SO_ZEROCOPY, (const char*)&v, sizeof(v))) {
+			char errbuf[1024];
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling zero-copy transmit: %s"),
+				pgm_sock_strerror_s (errbuf, sizeof (errbuf), pgm_get_last_sock_error()));
+			sock->use_zerocopy = FALSE;
+		} else {
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Create zero-copy completion ring of %u packets."), PGM_MAX_ZEROCOPY);
+			sock->zc_ring = pgm_new0 (struct pgm_zc_slot_t, PGM_MAX_ZEROCOPY);
+		}
+	}
+#else
+	sock->use_zerocopy = FALSE;
+#endif
+
+#ifdef SO_TIMESTAMPNS
+	if (sock->use_kernel_tstamp) {
+		const int v = 1;
+		if (SOCKET_ERROR == setsockopt (sock->recv_sock, SOL_SOCKET, SO_TIMESTAMPNS, (const char*)&v, sizeof(v))) {
+			char errbuf[1024];
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling kernel receive time stamps: %s"),
+				pgm_sock_strerror_s (errbuf, sizeof (errbuf), pgm_get_last_sock_error()));
+			sock->use_kernel_tstamp = FALSE;
+		}
+	}
+#else
+	sock->use_kernel_tstamp = FALSE;
+#endif
+
+/* socket buffers of max_tpdu recycled through a per-socket pool */
+	if (sock->skb_pool_depth > 0) {
+		pgm_trace (PGM_LOG_ROLE_MEMORY,_("Create socket buffer pool of %u slabs."), sock->skb_pool_depth);
+		sock->skb_pool = pgm_skb_pool_create (sock->max_tpdu, sock->skb_pool_depth, sock->hugepage_size, sock->use_mlock);
+	}
+
 /* allocate first incoming packet buffer */
-	sock->rx_buffer = pgm_alloc_skb (sock->max_tpdu);
+	sock->rx_buffer = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
+#if defined(HAVE_RECVMMSG) && defined(UDP_GRO)
+	if (sock->use_udp_gro) {
+		const int v = 1;
+		if (SOCKET_ERROR == setsockopt (sock->recv_sock, SOL_UDP, UDP_GRO, (const char*)&v, sizeof(v))) {
+			char errbuf[1024];
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling UDP generic receive offload: %s"),
+				pgm_sock_strerror_s (errbuf, sizeof (errbuf), pgm_get_last_sock_error()));
+			sock->use_udp_gro = FALSE;
+		} else {
+/* one coalesced buffer is limited to 64 segments by the kernel */
+			sock->rx_ring_size = PGM_MAX_RECV_BATCH;
+			sock->rx_gro_buffer = pgm_malloc (UINT16_MAX);
+		}
+	}
+#else
+	sock->use_udp_gro = FALSE;
+#endif
+#if defined(HAVE_RECVMMSG) && defined(HAVE_LINUX_IO_URING_H)
+/* coalesced buffers are scattered across the whole ring by one read */
+	if (sock->use_io_uring && sock->use_udp_gro) {
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling io_uring receive with UDP generic receive offload."));
+		sock->use_io_uring = FALSE;
+	}
+	if (sock->use_io_uring && sock->rx_ring_size < 2)
+		sock->rx_ring_size = PGM_MAX_RECV_BATCH;
+#else
+	sock->use_io_uring = FALSE;
+#endif
+#ifdef HAVE_RECVMMSG
+	if (sock->rx_ring_size > 1) {
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Create receive ring of %u packets."), sock->rx_ring_size);
+		sock->rx_ring = pgm_new0 (struct pgm_rx_slot_t, sock->rx_ring_size);
+		for (unsigned i = 0; i < sock->rx_ring_size; i++)
+			sock->rx_ring[i].skb = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
+	}
+#endif
+#if defined(HAVE_RECVMMSG) && defined(HAVE_LINUX_IO_URING_H)
+	if (sock->use_io_uring) {
+		sock->rx_uring = pgm_uring_create (sock->rx_ring_size);
+		if (NULL != sock->rx_uring) {
+/* requests wait in the kernel for data instead of completing with EAGAIN */
+			pgm_sockaddr_nonblocking (sock->recv_sock, FALSE);
+			for (unsigned i = 0; i < sock->rx_ring_size; i++)
+				if (!pgm_uring_recv_slot (sock->rx_uring, sock->recv_sock, &sock->rx_ring[i], i, sock->max_tpdu))
+					sock->rx_uring_rearm[ sock->rx_uring_rearm_len++ ] = i;
+			if (-1 == pgm_uring_submit (sock->rx_uring)) {
+				const int save_errno = errno;
+				pgm_uring_destroy (sock->rx_uring);
+				sock->rx_uring = NULL;
+				pgm_sockaddr_nonblocking (sock->recv_sock, TRUE);
+				errno = save_errno;
+			}
+		}
+		if (NULL == sock->rx_uring) {
+			char errbuf[1024];
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Disabling io_uring receive: %s"),
+				pgm_strerror_s (errbuf, sizeof (errbuf), errno));
+			sock->use_io_uring = FALSE;
+		} else {
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Posted %u io_uring receive requests."), sock->rx_ring_size);
+		}
+	}
+#endif
 
 /* bind complete */
 	sock->is_bound = TRUE;
@@ -2448,6 +2942,23 @@ pgm_getsockname (
 	return TRUE;
 }
 
+/* descriptor signalled on incoming data, the io_uring completion queue when
+ * receives are in flight in the kernel.
+ */
+
+static
+SOCKET
+pgm_recv_event_socket (
+	const pgm_sock_t* const	sock
+	)
+{
+#ifdef HAVE_LINUX_IO_URING_H
+	if (sock->rx_uring)
+		return pgm_uring_fd (sock->rx_uring);
+#endif
+	return sock->recv_sock;
+}
+
 /* add select parameters for the receive socket(s)
  *
  * returns highest file descriptor used plus one.
@@ -2475,9 +2986,9 @@ pgm_select_info (
 
 	if (readfds)
 	{
-		FD_SET(sock->recv_sock, readfds);
+		FD_SET(pgm_recv_event_socket (sock), readfds);
 #ifndef _WIN32
-		fds = sock->recv_sock + 1;
+		fds = pgm_recv_event_socket (sock) + 1;
 #else
 		fds = 1;
 #endif
@@ -2579,7 +3090,7 @@ pgm_wsapoll_info (
 	if (events & PGM_POLLIN)
 	{
 		pgm_assert ( (1 + nfds) <= *n_fds );
-		fds[nfds].fd = sock->recv_sock;
+		fds[nfds].fd = pgm_recv_event_socket (sock);
 		fds[nfds].events = PGM_POLLIN;
 		nfds++;
 		if (sock->can_send_data) {
@@ -2647,7 +3158,7 @@ pgm_epoll_ctl (
 	{
 		event.events = events & (EPOLLIN | EPOLLET | EPOLLONESHOT);
 		event.data.ptr = sock;
-		retval = epoll_ctl (epfd, op, sock->recv_sock, &event);
+		retval = epoll_ctl (epfd, op, pgm_recv_event_socket (sock), &event);
 		if (retval)
 			goto out;
 		if (sock->can_send_data) {
@@ -268,7 +268,11 @@ mock_pgm_txw_create (
 	const ssize_t		max_rte,
 	const bool		use_fec,
 	const uint8_t		rs_n,
-	const uint8_t		rs_k
+	const uint8_t		rs_k,
+	const uint8_t		rs_proactive_h,
+	const bool		rs_is_cauchy,
+	const size_t		page_size,
+	const bool		use_mlock
 	)
 {
 	pgm_txw_t* window = g_new0 (pgm_txw_t, 1);
@@ -1154,6 +1158,528 @@ START_TEST (test_set_udp_multicast_fail_001)
 }
 END_TEST
 
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_SEND_BATCH,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_send_batch_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SEND_BATCH;
+	const int send_batch	= 1;
+	const void* optval	= &send_batch;
+	const socklen_t optlen	= sizeof(send_batch);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_send_batch failed");
+	fail_unless (TRUE == sock->use_send_batch, "use_send_batch not set");
+}
+END_TEST
+
+START_TEST (test_set_send_batch_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SEND_BATCH;
+	const int send_batch	= 1;
+	const void* optval	= &send_batch;
+	const socklen_t optlen	= sizeof(send_batch);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_send_batch failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_RECV_BATCH,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_recv_batch_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_RECV_BATCH;
+	const int recv_batch	= 32;
+	const void* optval	= &recv_batch;
+	const socklen_t optlen	= sizeof(recv_batch);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_recv_batch failed");
+}
+END_TEST
+
+/* invalid batch size */
+START_TEST (test_set_recv_batch_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_RECV_BATCH;
+	const int recv_batch	= PGM_MAX_RECV_BATCH + 1;
+	const void* optval	= &recv_batch;
+	const socklen_t optlen	= sizeof(recv_batch);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_recv_batch failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_UDP_GSO,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_udp_gso_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->protocol = IPPROTO_UDP;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_UDP_GSO;
+	const int udp_gso	= 1;
+	const void* optval	= &udp_gso;
+	const socklen_t optlen	= sizeof(udp_gso);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_udp_gso failed");
+}
+END_TEST
+
+/* raw PGM socket */
+START_TEST (test_set_udp_gso_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_UDP_GSO;
+	const int udp_gso	= 1;
+	const void* optval	= &udp_gso;
+	const socklen_t optlen	= sizeof(udp_gso);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_udp_gso failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_UDP_GRO,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_udp_gro_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->protocol = IPPROTO_UDP;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_UDP_GRO;
+	const int udp_gro	= 1;
+	const void* optval	= &udp_gro;
+	const socklen_t optlen	= sizeof(udp_gro);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_udp_gro failed");
+}
+END_TEST
+
+/* raw PGM socket */
+START_TEST (test_set_udp_gro_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_UDP_GRO;
+	const int udp_gro	= 1;
+	const void* optval	= &udp_gro;
+	const socklen_t optlen	= sizeof(udp_gro);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_udp_gro failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_ZEROCOPY,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_zerocopy_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->protocol = IPPROTO_UDP;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_ZEROCOPY;
+	const int zerocopy	= 1;
+	const void* optval	= &zerocopy;
+	const socklen_t optlen	= sizeof(zerocopy);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_zerocopy failed");
+}
+END_TEST
+
+/* raw PGM socket */
+START_TEST (test_set_zerocopy_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_ZEROCOPY;
+	const int zerocopy	= 1;
+	const void* optval	= &zerocopy;
+	const socklen_t optlen	= sizeof(zerocopy);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_zerocopy failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_IO_URING,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_io_uring_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_IO_URING;
+	const int io_uring	= 1;
+	const void* optval	= &io_uring;
+	const socklen_t optlen	= sizeof(io_uring);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_io_uring failed");
+}
+END_TEST
+
+/* bound socket */
+START_TEST (test_set_io_uring_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_IO_URING;
+	const int io_uring	= 1;
+	const void* optval	= &io_uring;
+	const socklen_t optlen	= sizeof(io_uring);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_io_uring failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_RECV_TIMESTAMP,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_recv_timestamp_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_RECV_TIMESTAMP;
+	const int recv_timestamp = 1;
+	const void* optval	= &recv_timestamp;
+	const socklen_t optlen	= sizeof(recv_timestamp);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_recv_timestamp failed");
+}
+END_TEST
+
+/* bound socket */
+START_TEST (test_set_recv_timestamp_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_RECV_TIMESTAMP;
+	const int recv_timestamp = 1;
+	const void* optval	= &recv_timestamp;
+	const socklen_t optlen	= sizeof(recv_timestamp);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_recv_timestamp failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_FEC_CAUCHY,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_fec_cauchy_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_FEC_CAUCHY;
+	const int fec_cauchy	= 1;
+	const void* optval	= &fec_cauchy;
+	const socklen_t optlen	= sizeof(fec_cauchy);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_fec_cauchy failed");
+	fail_unless (TRUE == sock->use_cauchy_parity, "set_fec_cauchy failed");
+}
+END_TEST
+
+/* bound socket */
+START_TEST (test_set_fec_cauchy_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_FEC_CAUCHY;
+	const int fec_cauchy	= 1;
+	const void* optval	= &fec_cauchy;
+	const socklen_t optlen	= sizeof(fec_cauchy);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_fec_cauchy failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_UDP_CSUM_OFFLOAD,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_udp_csum_offload_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->protocol = IPPROTO_UDP;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_UDP_CSUM_OFFLOAD;
+	const int csum_offload	= 1;
+	const void* optval	= &csum_offload;
+	const socklen_t optlen	= sizeof(csum_offload);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_udp_csum_offload failed");
+	fail_unless (TRUE == sock->use_checksum_offload, "set_udp_csum_offload failed");
+}
+END_TEST
+
+/* raw PGM socket */
+START_TEST (test_set_udp_csum_offload_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_UDP_CSUM_OFFLOAD;
+	const int csum_offload	= 1;
+	const void* optval	= &csum_offload;
+	const socklen_t optlen	= sizeof(csum_offload);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_udp_csum_offload failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_RECV_SHARD,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(struct pgm_shardinfo_t)
+ *	)
+ */
+
+START_TEST (test_set_recv_shard_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_RECV_SHARD;
+	const struct pgm_shardinfo_t shardinfo = {
+		.shard_count	= 4,
+		.shard_index	= 3
+	};
+	const void* optval	= &shardinfo;
+	const socklen_t optlen	= sizeof(shardinfo);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_recv_shard failed");
+	fail_unless (4 == sock->recv_shard_count, "set_recv_shard failed");
+	fail_unless (3 == sock->recv_shard_index, "set_recv_shard failed");
+}
+END_TEST
+
+/* index out of range */
+START_TEST (test_set_recv_shard_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_RECV_SHARD;
+	const struct pgm_shardinfo_t shardinfo = {
+		.shard_count	= 4,
+		.shard_index	= 4
+	};
+	const void* optval	= &shardinfo;
+	const socklen_t optlen	= sizeof(shardinfo);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_recv_shard failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_SESSION_FILTER,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_session_filter_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SESSION_FILTER;
+	const int session_filter = 1;
+	const void* optval	= &session_filter;
+	const socklen_t optlen	= sizeof(session_filter);
+	fail_unless (FALSE == sock->use_session_filter, "set_session_filter failed");
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_session_filter failed");
+	fail_unless (TRUE == sock->use_session_filter, "set_session_filter failed");
+	int value = 0;
+	socklen_t valuelen = sizeof(value);
+	fail_unless (TRUE == pgm_getsockopt (sock, level, optname, &value, &valuelen), "get_session_filter failed");
+	fail_unless (1 == value, "get_session_filter failed");
+}
+END_TEST
+
+/* already bound */
+START_TEST (test_set_session_filter_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SESSION_FILTER;
+	const int session_filter = 1;
+	const void* optval	= &session_filter;
+	const socklen_t optlen	= sizeof(session_filter);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_session_filter failed");
+	fail_unless (FALSE == sock->use_session_filter, "set_session_filter failed");
+}
+END_TEST
+
+START_TEST (test_set_skb_pool_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SKB_POOL;
+	const int depth		= 1024;
+	const void* optval	= &depth;
+	const socklen_t optlen	= sizeof(depth);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_skb_pool failed");
+	fail_unless (1024 == sock->skb_pool_depth, "set_skb_pool failed");
+}
+END_TEST
+
+/* negative depth */
+START_TEST (test_set_skb_pool_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SKB_POOL;
+	const int depth		= -1;
+	const void* optval	= &depth;
+	const socklen_t optlen	= sizeof(depth);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_skb_pool failed");
+}
+END_TEST
+
+START_TEST (test_set_hugepages_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_HUGEPAGES;
+	const int page_size	= 2 * 1024 * 1024;
+	const void* optval	= &page_size;
+	const socklen_t optlen	= sizeof(page_size);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_hugepages failed");
+	fail_unless (2 * 1024 * 1024 == sock->hugepage_size, "set_hugepages failed");
+}
+END_TEST
+
+/* unsupported page size */
+START_TEST (test_set_hugepages_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_HUGEPAGES;
+	const int page_size	= 4096;
+	const void* optval	= &page_size;
+	const socklen_t optlen	= sizeof(page_size);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_hugepages failed");
+}
+END_TEST
+
+START_TEST (test_set_mlock_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_MLOCK;
+	const int use_mlock	= 1;
+	const void* optval	= &use_mlock;
+	const socklen_t optlen	= sizeof(use_mlock);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_mlock failed");
+	fail_unless (sock->use_mlock, "set_mlock failed");
+}
+END_TEST
+
+START_TEST (test_set_mlock_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_MLOCK;
+	const int use_mlock	= 1;
+	const void* optval	= &use_mlock;
+	const socklen_t optlen	= sizeof(use_mlock);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_mlock failed");
+}
+END_TEST
+
 static
 Suite*
 make_test_suite (void)
@@ -1263,6 +1789,90 @@ make_test_suite (void)
 	tcase_add_test (tc_set_noblock, test_set_noblock_pass_001);
 	tcase_add_test (tc_set_noblock, test_set_noblock_fail_001);
 
+	TCase* tc_set_send_batch = tcase_create ("set-send-batch");
+	suite_add_tcase (s, tc_set_send_batch);
+	tcase_add_checked_fixture (tc_set_send_batch, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_send_batch, test_set_send_batch_pass_001);
+	tcase_add_test (tc_set_send_batch, test_set_send_batch_fail_001);
+
+	TCase* tc_set_recv_batch = tcase_create ("set-recv-batch");
+	suite_add_tcase (s, tc_set_recv_batch);
+	tcase_add_checked_fixture (tc_set_recv_batch, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_recv_batch, test_set_recv_batch_pass_001);
+	tcase_add_test (tc_set_recv_batch, test_set_recv_batch_fail_001);
+
+	TCase* tc_set_udp_gso = tcase_create ("set-udp-gso");
+	suite_add_tcase (s, tc_set_udp_gso);
+	tcase_add_checked_fixture (tc_set_udp_gso, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_udp_gso, test_set_udp_gso_pass_001);
+	tcase_add_test (tc_set_udp_gso, test_set_udp_gso_fail_001);
+
+	TCase* tc_set_udp_gro = tcase_create ("set-udp-gro");
+	suite_add_tcase (s, tc_set_udp_gro);
+	tcase_add_checked_fixture (tc_set_udp_gro, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_udp_gro, test_set_udp_gro_pass_001);
+	tcase_add_test (tc_set_udp_gro, test_set_udp_gro_fail_001);
+
+	TCase* tc_set_zerocopy = tcase_create ("set-zerocopy");
+	suite_add_tcase (s, tc_set_zerocopy);
+	tcase_add_checked_fixture (tc_set_zerocopy, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_zerocopy, test_set_zerocopy_pass_001);
+	tcase_add_test (tc_set_zerocopy, test_set_zerocopy_fail_001);
+
+	TCase* tc_set_io_uring = tcase_create ("set-io-uring");
+	suite_add_tcase (s, tc_set_io_uring);
+	tcase_add_checked_fixture (tc_set_io_uring, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_io_uring, test_set_io_uring_pass_001);
+	tcase_add_test (tc_set_io_uring, test_set_io_uring_fail_001);
+
+	TCase* tc_set_recv_timestamp = tcase_create ("set-recv-timestamp");
+	suite_add_tcase (s, tc_set_recv_timestamp);
+	tcase_add_checked_fixture (tc_set_recv_timestamp, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_recv_timestamp, test_set_recv_timestamp_pass_001);
+	tcase_add_test (tc_set_recv_timestamp, test_set_recv_timestamp_fail_001);
+
+	TCase* tc_set_fec_cauchy = tcase_create ("set-fec-cauchy");
+	suite_add_tcase (s, tc_set_fec_cauchy);
+	tcase_add_checked_fixture (tc_set_fec_cauchy, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_fec_cauchy, test_set_fec_cauchy_pass_001);
+	tcase_add_test (tc_set_fec_cauchy, test_set_fec_cauchy_fail_001);
+
+	TCase* tc_set_udp_csum_offload = tcase_create ("set-udp-csum-offload");
+	suite_add_tcase (s, tc_set_udp_csum_offload);
+	tcase_add_checked_fixture (tc_set_udp_csum_offload, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_udp_csum_offload, test_set_udp_csum_offload_pass_001);
+	tcase_add_test (tc_set_udp_csum_offload, test_set_udp_csum_offload_fail_001);
+
+	TCase* tc_set_recv_shard = tcase_create ("set-recv-shard");
+	suite_add_tcase (s, tc_set_recv_shard);
+	tcase_add_checked_fixture (tc_set_recv_shard, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_recv_shard, test_set_recv_shard_pass_001);
+	tcase_add_test (tc_set_recv_shard, test_set_recv_shard_fail_001);
+
+	TCase* tc_set_session_filter = tcase_create ("set-session-filter");
+	suite_add_tcase (s, tc_set_session_filter);
+	tcase_add_checked_fixture (tc_set_session_filter, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_session_filter, test_set_session_filter_pass_001);
+	tcase_add_test (tc_set_session_filter, test_set_session_filter_fail_001);
+
+	TCase* tc_set_skb_pool = tcase_create ("set-skb-pool");
+	suite_add_tcase (s, tc_set_skb_pool);
+	tcase_add_checked_fixture (tc_set_skb_pool, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_skb_pool, test_set_skb_pool_pass_001);
+	tcase_add_test (tc_set_skb_pool, test_set_skb_pool_fail_001);
+
+	TCase* tc_set_hugepages = tcase_create ("set-hugepages");
+	suite_add_tcase (s, tc_set_hugepages);
+	tcase_add_checked_fixture (tc_set_hugepages, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_hugepages, test_set_hugepages_pass_001);
+	tcase_add_test (tc_set_hugepages, test_set_hugepages_fail_001);
+
+	TCase* tc_set_mlock = tcase_create ("set-mlock");
+	suite_add_tcase (s, tc_set_mlock);
+	tcase_add_checked_fixture (tc_set_mlock, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_mlock, test_set_mlock_pass_001);
+	tcase_add_test (tc_set_mlock, test_set_mlock_fail_001);
+
 	TCase* tc_set_udp_unicast = tcase_create ("set-udp-encap-ucast-port");
 	suite_add_tcase (s, tc_set_udp_unicast);
 	tcase_add_checked_fixture (tc_set_udp_unicast, mock_setup, mock_teardown);
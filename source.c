@@ -49,6 +49,7 @@ static int send_odata (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const res
 static int send_odata_copy (pgm_sock_t*const restrict, const void*restrict, const uint16_t, size_t*restrict);
 static int send_odatav (pgm_sock_t*const restrict, const struct pgm_iovec*const restrict, const unsigned, size_t*restrict);
 static bool send_rdata (pgm_sock_t*restrict, struct pgm_sk_buff_t*restrict);
+static bool send_odata_batch (pgm_sock_t*const restrict, const bool, size_t*restrict, unsigned*restrict, size_t*restrict);
 
 
 static inline
@@ -110,6 +111,82 @@ source_max_tsdu (
 	return max_tsdu;
 }
 
+/* payload checksum accumulator, with PGM_UDP_CSUM_OFFLOAD the transport
+ * checksum is trusted and the payload only copied.
+ */
+
+static inline
+uint32_t
+source_csum_partial (
+	const pgm_sock_t* const restrict sock,
+	const void*	  const restrict data,
+	const uint16_t			 len
+	)
+{
+	return sock->use_checksum_offload ? 0 : pgm_csum_partial (data, len, 0);
+}
+
+static inline
+uint32_t
+source_csum_partial_copy (
+	const pgm_sock_t* const restrict sock,
+	const void*	  const restrict src,
+	void*		  const restrict dst,
+	const uint16_t			 len
+	)
+{
+	if (sock->use_checksum_offload) {
+		memcpy (dst, src, len);
+		return 0;
+	}
+	return pgm_csum_partial_copy (src, dst, len, 0);
+}
+
+/* PGM checksum of a header with pgm_checksum = 0 and the payload checksum
+ * accumulator, zero for no transmitted checksum with PGM_UDP_CSUM_OFFLOAD.
+ */
+
+static inline
+uint16_t
+source_csum_fold (
+	const pgm_sock_t*	 const restrict sock,
+	const struct pgm_header* const restrict header,
+	const uint16_t				header_len,
+	const uint32_t				unfolded_odata
+	)
+{
+	uint32_t unfolded_header;
+
+	if (sock->use_checksum_offload)
+		return 0;
+	unfolded_header = pgm_csum_partial (header, header_len, 0);
+	return pgm_csum_fold (pgm_csum_block_add (unfolded_header, unfolded_odata, header_len));
+}
+
+/* add skb to the transmit window.  the publisher is the single writer of
+ * the leading edge which readers sample with pgm_txw_lead_atomic(), the lock
+ * is only taken when a full window drops the trailing skb from under the
+ * retransmit path, or when opening or closing a transmission group replaces
+ * proactive parity packets.
+ */
+
+static inline
+void
+source_txw_add (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	if (PGM_LIKELY(!pgm_txw_is_full (sock->window) &&
+		       !pgm_txw_is_tg_boundary (sock->window))) {
+		pgm_txw_add (sock->window, skb);
+		return;
+	}
+	pgm_spinlock_lock (&sock->txw_spinlock);
+	pgm_txw_add (sock->window, skb);
+	pgm_spinlock_unlock (&sock->txw_spinlock);
+}
+
 /* prototype of function to send pro-active parity NAKs.
  */
 
@@ -142,6 +219,7 @@ pgm_on_deferred_nak (
 	)
 {
 	struct pgm_sk_buff_t* skb;
+	bool is_cleared = FALSE;
 
 /* pre-conditions */
 	pgm_assert (NULL != sock);
@@ -155,9 +233,13 @@ pgm_on_deferred_nak (
  * provides the extra offset value.
  */
 
+/* release repair packets still held by zero-copy sends */
+	pgm_zerocopy_reap (sock);
+
 /* peek from the retransmit queue so we can eliminate duplicate NAKs up until the repair packet
  * has been retransmitted.
  */
+peek:
 	pgm_spinlock_lock (&sock->txw_spinlock);
 	skb = pgm_txw_retransmit_try_peek (sock->window);
 	if (skb) {
@@ -171,8 +253,21 @@ pgm_on_deferred_nak (
 		pgm_free_skb (skb);
 /* now remove sequence number from retransmit queue, re-enabling NAK processing for this sequence number */
 		pgm_txw_retransmit_remove_head (sock->window);
-	} else
+	} else {
 		pgm_spinlock_unlock (&sock->txw_spinlock);
+/* a repair packet held by a zero-copy send is re-signalled on completion, clear
+ * the notification rather than spin on it and peek again for a release that
+ * raced the clear.
+ */
+		if (NULL != sock->zc_ring &&
+		    !is_cleared &&
+		    !pgm_txw_retransmit_is_empty (sock->window))
+		{
+			pgm_notify_clear (&sock->rdata_notify);
+			is_cleared = TRUE;
+			goto peek;
+		}
+	}
 	return TRUE;
 }
 
@@ -765,7 +860,8 @@ pgm_send_spm (
 			opt_header->opt_length	= sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_parity_prm);
 			opt_parity_prm = (struct pgm_opt_parity_prm*)(opt_header + 1);
 			opt_parity_prm->opt_reserved = (sock->use_proactive_parity ? PGM_PARITY_PRM_PRO : 0) |
-						       (sock->use_ondemand_parity ? PGM_PARITY_PRM_OND : 0);
+						       (sock->use_ondemand_parity ? PGM_PARITY_PRM_OND : 0) |
+						       (sock->use_cauchy_parity ? PGM_PARITY_PRM_CAUCHY : 0);
 			opt_parity_prm->parity_prm_tgs = htonl (sock->rs_k);
 			last_opt_header = opt_header;
 			opt_header = (struct pgm_opt_header*)(opt_parity_prm + 1);
@@ -1065,6 +1161,74 @@ reset_heartbeat_spm (
  */
 #define STATE(x)	(sock->pkt_dontwait_state.x)
 
+/* send ODATA fragments collected in the resume state with as few system calls
+ * as possible, continuing from the first unsent fragment if previously blocked.
+ * fragments are already in the transmit window with unfolded checksums saved.
+ *
+ * on success, returns TRUE.  on block for non-blocking sockets or exceeding the
+ * rate limit returns FALSE, with errno and sock::blocklen set appropriately.
+ */
+
+static
+bool
+send_odata_batch (
+	pgm_sock_t*	 const restrict	sock,
+	const bool			is_skb_reference,	/* release reference taken on application skb */
+	size_t*		       restrict	bytes_sent,
+	unsigned*	       restrict	packets_sent,
+	size_t*		       restrict	data_bytes_sent
+	)
+{
+	struct pgm_iovec vector[PGM_MAX_FRAGMENTS];
+	const size_t count = STATE(batch_len) - STATE(batch_offset);
+	size_t i, sent;
+
+	pgm_assert (NULL != sock);
+	pgm_assert (count > 0);
+
+	for (i = 0; i < count; i++) {
+		const struct pgm_sk_buff_t* skb = STATE(batch)[ STATE(batch_offset) + i ];
+		pgm_assert ((const char*)skb->tail > (const char*)skb->head);
+		vector[i].iov_base = skb->head;
+		vector[i].iov_len  = (const char*)skb->tail - (const char*)skb->head;
+	}
+
+	sent = pgm_sendmmsg (sock,
+			     !STATE(is_rate_limited),	/* rate limit on blocking */
+			     &sock->odata_rate_control,
+			     FALSE,			/* regular socket */
+			     vector,
+			     &STATE(batch)[ STATE(batch_offset) ],
+			     count,
+			     (struct sockaddr*)&sock->send_gsr.gsr_group,
+			     pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+
+	for (i = 0; i < sent; i++) {
+		struct pgm_sk_buff_t* skb = STATE(batch)[ STATE(batch_offset)++ ];
+		*bytes_sent += vector[i].iov_len + sock->iphdr_len;	/* as counted at IP layer */
+		(*packets_sent)++;					/* IP packets */
+		*data_bytes_sent += ntohs (skb->pgm_header->pgm_tsdu_length);
+
+/* check for end of transmission group */
+		if (sock->use_proactive_parity) {
+			const uint32_t odata_sqn   = ntohl (skb->pgm_data->data_sqn);
+			const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+			if (!((odata_sqn + 1) & ~tg_sqn_mask))
+				pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+		}
+		if (is_skb_reference)
+			pgm_free_skb (skb);
+	}
+
+	if (sent < count) {
+		sock->blocklen = vector[sent].iov_len + sock->iphdr_len;
+		return FALSE;
+	}
+
+	STATE(batch_len) = STATE(batch_offset) = 0;
+	return TRUE;
+}
+
 /* send one PGM data packet, transmit window owned memory.
  *
  * On success, returns PGM_IO_STATUS_NORMAL and the number of data bytes pushed
@@ -1152,14 +1316,11 @@ send_odata (
 		data = (char*)opt_header + opt_header->opt_length;
 	}
 	const size_t   pgm_header_len		= (char*)data - (char*)STATE(skb)->pgm_header;
-	const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
-	STATE(unfolded_odata)			= pgm_csum_partial (data, (uint16_t)tsdu_length, 0);
-        STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
+	STATE(unfolded_odata)			= source_csum_partial (sock, data, (uint16_t)tsdu_length);
+        STATE(skb)->pgm_header->pgm_checksum	= source_csum_fold (sock, STATE(skb)->pgm_header, (uint16_t)pgm_header_len, STATE(unfolded_odata));
 
 /* add to transmit window, skb::data set to payload */
-	pgm_spinlock_lock (&sock->txw_spinlock);
-	pgm_txw_add (sock->window, STATE(skb));
-	pgm_spinlock_unlock (&sock->txw_spinlock);
+	source_txw_add (sock, STATE(skb));
 
 /* check rate limit at last moment */
 	STATE(is_rate_limited) = FALSE;
@@ -1282,7 +1443,7 @@ send_odata_copy (
 		goto retry_send;
 	}
 
-	STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+	STATE(skb) = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
 	STATE(skb)->sock = sock;
 	STATE(skb)->tstamp = pgm_time_update_now();
 	pgm_skb_reserve (STATE(skb), (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
@@ -1329,14 +1490,11 @@ send_odata_copy (
 		data = (char*)opt_header + opt_header->opt_length;
 	}
 	const size_t   pgm_header_len		= (char*)data - (char*)STATE(skb)->pgm_header;
-	const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
-	STATE(unfolded_odata)			= pgm_csum_partial_copy (tsdu, data, (uint16_t)tsdu_length, 0);
-	STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
+	STATE(unfolded_odata)			= source_csum_partial_copy (sock, tsdu, data, (uint16_t)tsdu_length);
+	STATE(skb)->pgm_header->pgm_checksum	= source_csum_fold (sock, STATE(skb)->pgm_header, (uint16_t)pgm_header_len, STATE(unfolded_odata));
 
 /* add to transmit window, skb::data set to payload */
-	pgm_spinlock_lock (&sock->txw_spinlock);
-	pgm_txw_add (sock->window, STATE(skb));
-	pgm_spinlock_unlock (&sock->txw_spinlock);
+	source_txw_add (sock, STATE(skb));
 
 /* check rate limit at last moment */
 	STATE(is_rate_limited) = FALSE;
@@ -1475,7 +1633,7 @@ send_odatav (
 	}
 	pgm_return_val_if_fail (STATE(tsdu_length) <= sock->max_tsdu, PGM_IO_STATUS_ERROR);
 
-	STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+	STATE(skb) = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
 	STATE(skb)->sock = sock;
 	STATE(skb)->tstamp = pgm_time_update_now();
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
@@ -1497,25 +1655,22 @@ send_odatav (
 
 	STATE(skb)->pgm_header->pgm_checksum	= 0;
 	const size_t   pgm_header_len		= (char*)(STATE(skb)->pgm_data + 1) - (char*)STATE(skb)->pgm_header;
-	const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
 
 /* unroll first iteration to make friendly branch prediction */
 	dst			= (char*)(STATE(skb)->pgm_data + 1);
-	STATE(unfolded_odata)	= pgm_csum_partial_copy ((const char*)vector[0].iov_base, dst, (uint16_t)vector[0].iov_len, 0);
+	STATE(unfolded_odata)	= source_csum_partial_copy (sock, (const char*)vector[0].iov_base, dst, (uint16_t)vector[0].iov_len);
 
 /* iterate over one or more vector elements to perform scatter/gather checksum & copy */
 	for (unsigned i = 1; i < count; i++) {
 		dst += vector[i-1].iov_len;
-		const uint32_t unfolded_element = pgm_csum_partial_copy ((const char*)vector[i].iov_base, dst, (uint16_t)vector[i].iov_len, 0);
+		const uint32_t unfolded_element = source_csum_partial_copy (sock, (const char*)vector[i].iov_base, dst, (uint16_t)vector[i].iov_len);
 		STATE(unfolded_odata) = pgm_csum_block_add (STATE(unfolded_odata), unfolded_element, (uint16_t)vector[i-1].iov_len);
 	}
 
-	STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
+	STATE(skb)->pgm_header->pgm_checksum	= source_csum_fold (sock, STATE(skb)->pgm_header, (uint16_t)pgm_header_len, STATE(unfolded_odata));
 
 /* add to transmit window, skb::data set to payload */
-	pgm_spinlock_lock (&sock->txw_spinlock);
-	pgm_txw_add (sock->window, STATE(skb));
-	pgm_spinlock_unlock (&sock->txw_spinlock);
+	source_txw_add (sock, STATE(skb));
 
 	pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 	tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
@@ -1614,8 +1769,11 @@ send_apdu (
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
 
 /* continue if blocked mid-apdu */
-	if (sock->is_apdu_eagain)
+	if (sock->is_apdu_eagain) {
+		if (STATE(batch_len))
+			goto retry_batch_send;
 		goto retry_send;
+	}
 
 /* if non-blocking calculate total wire size and check rate limit */
 	STATE(is_rate_limited) = FALSE;
@@ -1644,6 +1802,8 @@ send_apdu (
 
 	STATE(data_bytes_offset)	= 0;
 	STATE(first_sqn)		= pgm_txw_next_lead(sock->window);
+	STATE(batch_len)		= 0;
+	STATE(batch_offset)		= 0;
 
 	do {
 		size_t			 tpdu_length, header_length;
@@ -1655,7 +1815,7 @@ send_apdu (
 		header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		STATE(tsdu_length) = MIN( source_max_tsdu (sock, TRUE), apdu_length - STATE(data_bytes_offset) );
 
-		STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+		STATE(skb) = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
 		STATE(skb)->sock = sock;
 		STATE(skb)->tstamp = pgm_time_update_now();
 		pgm_skb_reserve (STATE(skb), (uint16_t)header_length);
@@ -1695,14 +1855,19 @@ send_apdu (
 /* TODO: the assembly checksum & copy routine is faster than memcpy & pgm_cksum on >= opteron hardware */
 		STATE(skb)->pgm_header->pgm_checksum	= 0;
 		const size_t   pgm_header_len		= (char*)(STATE(skb)->pgm_opt_fragment + 1) - (char*)STATE(skb)->pgm_header;
-		const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
-		STATE(unfolded_odata)			= pgm_csum_partial_copy ((const char*)apdu + STATE(data_bytes_offset), STATE(skb)->pgm_opt_fragment + 1, (uint16_t)STATE(tsdu_length), 0);
-		STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
+		STATE(unfolded_odata)			= source_csum_partial_copy (sock, (const char*)apdu + STATE(data_bytes_offset), STATE(skb)->pgm_opt_fragment + 1, (uint16_t)STATE(tsdu_length));
+		STATE(skb)->pgm_header->pgm_checksum	= source_csum_fold (sock, STATE(skb)->pgm_header, (uint16_t)pgm_header_len, STATE(unfolded_odata));
 
 /* add to transmit window, skb::data set to payload */
-		pgm_spinlock_lock (&sock->txw_spinlock);
-		pgm_txw_add (sock->window, STATE(skb));
-		pgm_spinlock_unlock (&sock->txw_spinlock);
+		source_txw_add (sock, STATE(skb));
+
+/* defer to one batched send of all fragments */
+		if (sock->use_send_batch || sock->use_udp_gso || sock->use_zerocopy) {
+			pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
+			STATE(batch)[ STATE(batch_len)++ ] = STATE(skb);
+			STATE(data_bytes_offset) += STATE(tsdu_length);
+			continue;
+		}
 
 retry_send:
 		pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
@@ -1748,6 +1913,15 @@ retry_send:
 	} while ( STATE(data_bytes_offset)  < apdu_length);
 	pgm_assert( STATE(data_bytes_offset) == apdu_length );
 
+	if (STATE(batch_len)) {
+retry_batch_send:
+		if (!send_odata_batch (sock, FALSE, &bytes_sent, &packets_sent, &data_bytes_sent)) {
+			save_errno = pgm_get_last_sock_error();
+			sock->is_apdu_eagain = TRUE;
+			goto blocked;
+		}
+	}
+
 /* success */
 	sock->is_apdu_eagain = FALSE;
 /* SPM heartbeats decay from last sent data packet */
@@ -1905,6 +2079,8 @@ pgm_sendv (
 				pgm_rwlock_reader_unlock (&sock->lock);
 				return status;
 			}
+			else if (STATE(batch_len))
+				goto retry_batch_send;
 			else
 				goto retry_one_apdu_send;
 		} else {
@@ -2016,6 +2192,8 @@ retry_send:
 	STATE(vector_offset)		= 0;
 
 	STATE(first_sqn)		= pgm_txw_next_lead(sock->window);
+	STATE(batch_len)		= 0;
+	STATE(batch_offset)		= 0;
 
 	do {
 		size_t			 tpdu_length, header_length;
@@ -2029,7 +2207,7 @@ retry_send:
 /* retrieve packet storage from transmit window */
 		header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		STATE(tsdu_length) = MIN( source_max_tsdu (sock, TRUE), STATE(apdu_length) - STATE(data_bytes_offset) );
-		STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+		STATE(skb) = pgm_skb_pool_alloc (sock->skb_pool, sock->max_tpdu);
 		STATE(skb)->sock = sock;
 		STATE(skb)->tstamp = pgm_time_update_now();
 		pgm_skb_reserve (STATE(skb), (uint16_t)header_length);
@@ -2069,7 +2247,6 @@ retry_send:
 /* checksum & copy */
 		STATE(skb)->pgm_header->pgm_checksum	= 0;
 		const size_t   pgm_header_len		= (char*)(STATE(skb)->pgm_opt_fragment + 1) - (char*)STATE(skb)->pgm_header;
-		const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
 
 /* iterate over one or more vector elements to perform scatter/gather checksum & copy
  *
@@ -2082,7 +2259,7 @@ retry_send:
 		src_length	= vector[STATE(vector_index)].iov_len - STATE(vector_offset);
 		dst_length	= 0;
 		copy_length	= MIN( STATE(tsdu_length), src_length );
-		STATE(unfolded_odata)	= pgm_csum_partial_copy (src, dst, (uint16_t)copy_length, 0);
+		STATE(unfolded_odata)	= source_csum_partial_copy (sock, src, dst, (uint16_t)copy_length);
 
 		for(;;)
 		{
@@ -2105,16 +2282,22 @@ retry_send:
 			dst	       += copy_length;
 			src_length	= vector[STATE(vector_index)].iov_len - STATE(vector_offset);
 			copy_length	= MIN( STATE(tsdu_length) - dst_length, src_length );
-			const uint32_t unfolded_element = pgm_csum_partial_copy (src, dst, (uint16_t)copy_length, 0);
+			const uint32_t unfolded_element = source_csum_partial_copy (sock, src, dst, (uint16_t)copy_length);
 			STATE(unfolded_odata) = pgm_csum_block_add (STATE(unfolded_odata), unfolded_element, (uint16_t)dst_length);
 		}
 
-		STATE(skb)->pgm_header->pgm_checksum = pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
+		STATE(skb)->pgm_header->pgm_checksum = source_csum_fold (sock, STATE(skb)->pgm_header, (uint16_t)pgm_header_len, STATE(unfolded_odata));
 
 /* add to transmit window, skb::data set to payload */
-		pgm_spinlock_lock (&sock->txw_spinlock);
-		pgm_txw_add (sock->window, STATE(skb));
-		pgm_spinlock_unlock (&sock->txw_spinlock);
+		source_txw_add (sock, STATE(skb));
+
+/* defer to one batched send of all fragments */
+		if (sock->use_send_batch || sock->use_udp_gso || sock->use_zerocopy) {
+			pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
+			STATE(batch)[ STATE(batch_len)++ ] = STATE(skb);
+			STATE(data_bytes_offset) += STATE(tsdu_length);
+			continue;
+		}
 
 retry_one_apdu_send:
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
@@ -2159,6 +2342,15 @@ retry_one_apdu_send:
 	} while ( STATE(data_bytes_offset)  < STATE(apdu_length) );
 	pgm_assert( STATE(data_bytes_offset) == STATE(apdu_length) );
 
+	if (STATE(batch_len)) {
+retry_batch_send:
+		if (!send_odata_batch (sock, FALSE, &bytes_sent, &packets_sent, &data_bytes_sent)) {
+			save_errno = pgm_get_last_sock_error();
+			sock->is_apdu_eagain = TRUE;
+			goto blocked;
+		}
+	}
+
 /* success */
 	sock->is_apdu_eagain = FALSE;
 /* SPM heartbeats decay from last sent data packet */
@@ -2254,8 +2446,11 @@ pgm_send_skbv (
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
 
 /* continue if blocked mid-apdu */
-	if (sock->is_apdu_eagain)
+	if (sock->is_apdu_eagain) {
+		if (STATE(batch_len))
+			goto retry_batch_send;
 		goto retry_send;
+	}
 
 	STATE(is_rate_limited) = FALSE;
 	if (sock->is_nonblocking && sock->is_controlled_odata)
@@ -2298,6 +2493,8 @@ pgm_send_skbv (
 		}
 	}
 
+	STATE(batch_len)	= 0;
+	STATE(batch_offset)	= 0;
 	for (STATE(vector_index) = 0; STATE(vector_index) < count; STATE(vector_index)++)
 	{
 		size_t		tpdu_length;
@@ -2356,14 +2553,19 @@ pgm_send_skbv (
 		STATE(skb)->pgm_header->pgm_checksum	= 0;
 		pgm_assert ((char*)STATE(skb)->data > (char*)STATE(skb)->pgm_header);
 		const size_t header_length		= (char*)STATE(skb)->data - (char*)STATE(skb)->pgm_header;
-		const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)header_length, 0);
-		STATE(unfolded_odata)			= pgm_csum_partial ((char*)STATE(skb)->data, (uint16_t)STATE(tsdu_length), 0);
-		STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)header_length));
+		STATE(unfolded_odata)			= source_csum_partial (sock, (char*)STATE(skb)->data, (uint16_t)STATE(tsdu_length));
+		STATE(skb)->pgm_header->pgm_checksum	= source_csum_fold (sock, STATE(skb)->pgm_header, (uint16_t)header_length, STATE(unfolded_odata));
 
 /* add to transmit window, skb::data set to payload */
-		pgm_spinlock_lock (&sock->txw_spinlock);
-		pgm_txw_add (sock->window, STATE(skb));
-		pgm_spinlock_unlock (&sock->txw_spinlock);
+		source_txw_add (sock, STATE(skb));
+
+/* defer to one batched send of all fragments */
+		if (sock->use_send_batch || sock->use_udp_gso || sock->use_zerocopy) {
+			pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
+			STATE(batch)[ STATE(batch_len)++ ] = STATE(skb);
+			STATE(data_bytes_offset) += STATE(tsdu_length);
+			continue;
+		}
 retry_send:
 		pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
@@ -2414,6 +2616,15 @@ retry_send:
 	}
 #endif
 
+	if (STATE(batch_len)) {
+retry_batch_send:
+		if (!send_odata_batch (sock, TRUE, &bytes_sent, &packets_sent, &data_bytes_sent)) {
+			save_errno = pgm_get_last_sock_error();
+			sock->is_apdu_eagain = TRUE;
+			goto blocked;
+		}
+	}
+
 /* success */
 	sock->is_apdu_eagain = FALSE;
 /* SPM heartbeats decay from last sent data packet */
@@ -2486,15 +2697,16 @@ send_rdata (
 /* update previous odata/rdata contents */
 	header				= skb->pgm_header;
 	rdata				= skb->pgm_data;
+/* parity packets are built by the transmit window without port numbers */
+	header->pgm_sport		= sock->tsi.sport;
+	header->pgm_dport		= sock->dport;
 	header->pgm_type		= PGM_RDATA;
 /* RDATA */
         rdata->data_trail		= htonl (pgm_txw_trail(sock->window));
 
         header->pgm_checksum		= 0;
 	const size_t header_length	= tpdu_length - ntohs(header->pgm_tsdu_length);
-	const uint32_t unfolded_header	= pgm_csum_partial (header, (uint16_t)header_length, 0);
-	const uint32_t unfolded_odata	= pgm_txw_get_unfolded_checksum (skb);
-	header->pgm_checksum		= pgm_csum_fold (pgm_csum_block_add (unfolded_header, unfolded_odata, (uint16_t)header_length));
+	header->pgm_checksum		= source_csum_fold (sock, header, (uint16_t)header_length, pgm_txw_get_unfolded_checksum (skb));
 
 /* congestion control */
 	if (sock->use_pgmcc &&
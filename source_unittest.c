@@ -73,6 +73,7 @@ static gboolean mock_is_valid_nnak = TRUE;
 #define pgm_txw_retransmit_push		mock_pgm_txw_retransmit_push
 #define pgm_txw_retransmit_try_peek	mock_pgm_txw_retransmit_try_peek
 #define pgm_txw_retransmit_remove_head	mock_pgm_txw_retransmit_remove_head
+#define pgm_txw_retransmit_is_empty	mock_pgm_txw_retransmit_is_empty
 #define pgm_rs_encode			mock_pgm_rs_encode
 #define pgm_rate_check			mock_pgm_rate_check
 #define pgm_verify_spmr			mock_pgm_verify_spmr
@@ -84,6 +85,8 @@ static gboolean mock_is_valid_nnak = TRUE;
 #define pgm_csum_block_add		mock_pgm_csum_block_add
 #define pgm_csum_fold			mock_pgm_csum_fold
 #define pgm_sendto_hops			mock_pgm_sendto_hops
+#define pgm_sendmmsg			mock_pgm_sendmmsg
+#define pgm_zerocopy_reap		mock_pgm_zerocopy_reap
 #define pgm_time_update_now		mock_pgm_time_update_now
 #define pgm_setsockopt			mock_pgm_setsockopt
 
@@ -360,6 +363,16 @@ mock_pgm_txw_retransmit_try_peek (
 	return generate_odata (); 
 }
 
+bool
+mock_pgm_txw_retransmit_is_empty (
+	const pgm_txw_t* const		window
+	)
+{
+	g_debug ("mock_pgm_txw_retransmit_is_empty (window:%p)",
+		(gconstpointer)window);
+	return FALSE;
+}
+
 void
 mock_pgm_txw_retransmit_remove_head (
 	pgm_txw_t* const		window
@@ -495,6 +508,55 @@ mock_pgm_sendto_hops (
 	return len;
 }
 
+/* number of datagrams mock_pgm_sendmmsg will accept per call before blocking,
+ * zero for unlimited.
+ */
+static size_t mock_sendmmsg_limit = 0;
+static size_t mock_sendmmsg_packets = 0;
+
+PGM_GNUC_INTERNAL
+size_t
+mock_pgm_sendmmsg (
+	pgm_sock_t*			sock,
+	bool				use_rate_limit,
+	pgm_rate_t*			minor_rate_control,
+	bool				use_router_alert,
+	const struct pgm_iovec*		vector,
+	struct pgm_sk_buff_t*const*	skbs,
+	size_t				count,
+	const struct sockaddr*		to,
+	socklen_t			tolen
+	)
+{
+	char saddr[INET6_ADDRSTRLEN];
+	pgm_sockaddr_ntop (to, saddr, sizeof(saddr));
+	g_debug ("mock_pgm_sendmmsg (sock:%p use-rate-limit:%s minor-rate-control:%p use-router-alert:%s vector:%p count:%u to:%s tolen:%d)",
+		(gpointer)sock,
+		use_rate_limit ? "YES" : "NO",
+		(gpointer)minor_rate_control,
+		use_router_alert ? "YES" : "NO",
+		(gconstpointer)vector,
+		(unsigned)count,
+		saddr,
+		tolen);
+	if (mock_sendmmsg_limit && count > mock_sendmmsg_limit) {
+		mock_sendmmsg_packets += mock_sendmmsg_limit;
+		errno = EAGAIN;
+		return mock_sendmmsg_limit;
+	}
+	mock_sendmmsg_packets += count;
+	return count;
+}
+
+PGM_GNUC_INTERNAL
+void
+mock_pgm_zerocopy_reap (
+	pgm_sock_t*			sock
+	)
+{
+	g_debug ("mock_pgm_zerocopy_reap (sock:%p)", (gpointer)sock);
+}
+
 /** time module */
 static pgm_time_t _mock_pgm_time_update_now (void);
 pgm_time_update_func mock_pgm_time_update_now = _mock_pgm_time_update_now;
@@ -583,6 +645,36 @@ START_TEST (test_send_pass_002)
 }
 END_TEST
 
+/* large apdu, partial batch send resumes from first unsent fragment */
+START_TEST (test_send_pass_003)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	sock->is_nonblocking = TRUE;
+	sock->use_send_batch = TRUE;
+	const gsize apdu_length = 16000;
+	guint8 buffer[ apdu_length ];
+	gsize bytes_written;
+	mock_sendmmsg_limit = 3;
+	mock_sendmmsg_packets = 0;
+	fail_unless (PGM_IO_STATUS_WOULD_BLOCK == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not would-block");
+	fail_unless (TRUE == sock->is_apdu_eagain, "apdu not eagain");
+	const size_t batch_len = sock->pkt_dontwait_state.batch_len;
+	fail_unless (batch_len > 3, "apdu not fragmented");
+	fail_unless (3 == sock->pkt_dontwait_state.batch_offset, "batch offset not advanced");
+	fail_unless (3 == mock_sendmmsg_packets, "unexpected packet count");
+	fail_unless (0 < sock->blocklen, "blocklen not set");
+/* resume with remaining fragments only */
+	mock_sendmmsg_limit = 0;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not normal");
+	fail_unless ((gssize)apdu_length == bytes_written, "send underrun");
+	fail_unless (FALSE == sock->is_apdu_eagain, "apdu still eagain");
+	fail_unless (0 == sock->pkt_dontwait_state.batch_len, "batch not reset");
+	fail_unless (batch_len == mock_sendmmsg_packets, "fragments resent or dropped");
+}
+END_TEST
+
 START_TEST (test_send_fail_001)
 {
 	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
@@ -1158,6 +1250,7 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_send, mock_setup, NULL);
 	tcase_add_test (tc_send, test_send_pass_001);
 	tcase_add_test (tc_send, test_send_pass_002);
+	tcase_add_test (tc_send, test_send_pass_003);
 	tcase_add_test (tc_send, test_send_fail_001);
 
 	TCase* tc_sendv = tcase_create ("sendv");
@@ -430,7 +430,7 @@ on_io_data (
 
 /* parse packet to maintain peer database */
 	if (sock->udp_encap_ucast_port) {
-		if (!pgm_parse_udp_encap (skb, NULL))
+		if (!pgm_parse_udp_encap (skb, FALSE, NULL))
 			goto out;
         } else {
 		struct sockaddr_storage addr;
@@ -438,6 +438,12 @@ on_io_data (
                         goto out;
         }
 
+/* data packet checksums are deferred by the parser */
+	if ((PGM_ODATA == skb->pgm_header->pgm_type ||
+	     PGM_RDATA == skb->pgm_header->pgm_type) &&
+	    !pgm_verify_checksum (skb))
+		goto out;
+
 	if (PGM_IS_UPSTREAM (skb->pgm_header->pgm_type) ||
 	    PGM_IS_PEER (skb->pgm_header->pgm_type))
 		goto out;	/* ignore */
@@ -1574,7 +1580,10 @@ net_send_parity (
 
 	memset (data + 1, 0, parity_length);
 	pgm_rs_t rs;
-	pgm_rs_create (&rs, sock->rs_n, sock->rs_k);
+	if (sock->use_cauchy_parity)
+		pgm_rs_create_cauchy (&rs, sock->rs_n, sock->rs_k);
+	else
+		pgm_rs_create (&rs, sock->rs_n, sock->rs_k);
 	pgm_rs_encode (&rs, (const pgm_gf8_t**)src, sock->rs_k + rs_h, (pgm_gf8_t*)(data + 1), parity_length);
 	pgm_rs_destroy (&rs);
 
@@ -62,6 +62,7 @@ pgm_time_since_epoch_func	pgm_time_since_epoch PGM_GNUC_READ_MOSTLY;
 
 static volatile uint32_t	time_ref_count = 0;
 static pgm_time_t		rel_offset PGM_GNUC_READ_MOSTLY = 0;
+static pgm_time_t		wall_offset PGM_GNUC_READ_MOSTLY = 0;
 
 #ifdef _WIN32
 static UINT			wTimerRes = 0;
@@ -534,6 +535,14 @@ pgm_time_init (
 	rel_offset = 0;
 #endif
 
+/* offset from wall clock for kernel time stamps */
+#ifdef HAVE_GETTIMEOFDAY
+	if (pgm_time_update_now != pgm_gettimeofday_update)
+		wall_offset = pgm_gettimeofday_update() - pgm_time_update_now();
+	else
+		wall_offset = 0;
+#endif
+
 /* update Windows timer resolution to 1ms */
 #ifdef _WIN32
 	TIMECAPS tc;
@@ -584,6 +593,19 @@ pgm_time_shutdown (void)
 	return retval;
 }
 
+/* convert a wall clock time stamp in microseconds, as delivered by the kernel
+ * with SO_TIMESTAMPNS, to the active time stamp function.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_time_t
+pgm_time_from_wallclock (
+	const pgm_time_t	wallclock
+	)
+{
+	return wallclock - wall_offset;
+}
+
 #ifdef HAVE_GETTIMEOFDAY
 static
 pgm_time_t
@@ -74,7 +74,10 @@ pgm_tsi_print (
 	return buf;
 }
 
-/* create hash value of TSI for use with GLib hash tables.
+/* create hash value of TSI for use with GLib hash tables.  both words are
+ * mixed with the MurmurHash3 32-bit finaliser, a plain exclusive-or of the
+ * words collides whenever two TSIs differ by the same bits in each word, as
+ * is common for GSIs derived from similar host names or addresses.
  *
  * on success, returns a hash value corresponding to the TSI.  on error, fails
  * on assert.
@@ -94,7 +97,15 @@ pgm_tsi_hash (
 /* pre-conditions */
 	pgm_assert (NULL != p);
 
-	return u->l[0] ^ u->l[1];
+	uint32_t h = u->l[0] * 0xcc9e2d51;
+	h = ((h << 15) | (h >> 17)) ^ u->l[1];
+	h *= 0x1b873593;
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
 }
 
 /* compare two transport session identifier TSI values.
@@ -143,6 +143,33 @@ START_TEST (test_equal_fail_002)
 }
 END_TEST
 
+/* target:
+ *	pgm_hash_t
+ *	pgm_tsi_hash (
+ *		gconstpointer	tsi
+ *	)
+ */
+
+/* GSIs differing by the same bits in each word */
+START_TEST (test_hash_pass_001)
+{
+	pgm_hash_t hash[256];
+	for (unsigned i = 0; i < G_N_ELEMENTS(hash); i++) {
+		const pgm_tsi_t tsi = { { i, 2, 3, 4, i, 6 }, 1000 };
+		hash[i] = pgm_tsi_hash (&tsi);
+		for (unsigned j = 0; j < i; j++)
+			fail_if (hash[i] == hash[j], "hash collision");
+	}
+}
+END_TEST
+
+START_TEST (test_hash_fail_001)
+{
+	pgm_hash_t hash = pgm_tsi_hash (NULL);
+	fail ("reached");
+}
+END_TEST
+
 
 static
 Suite*
@@ -171,6 +198,13 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_equal, test_equal_fail_002, SIGABRT);
 #endif
 
+	TCase* tc_hash = tcase_create ("hash");
+	suite_add_tcase (s, tc_hash);
+	tcase_add_test (tc_hash, test_hash_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_hash, test_hash_fail_001, SIGABRT);
+#endif
+
 	return s;
 }
 
@@ -24,6 +24,7 @@
 #endif
 #include <impl/i18n.h>
 #include <impl/framework.h>
+#include <impl/mem.h>
 #include <impl/txw.h>
 
 
@@ -75,7 +76,10 @@ _pgm_txw_peek (
 	if (pgm_txw_is_empty (window))
 		return NULL;
 
-	if (pgm_uint32_gte (sequence, window->trail) && pgm_uint32_lte (sequence, window->lead))
+/* window edges may be advanced by the publisher without the transmit window lock */
+	const uint32_t trail = pgm_txw_trail_atomic (window);
+	const uint32_t lead  = pgm_txw_lead_atomic (window);
+	if (pgm_uint32_gte (sequence, trail) && pgm_uint32_lte (sequence, lead))
 	{
 		const uint_fast32_t index_ = sequence % pgm_txw_max_length (window);
 		skb = window->pdata[index_];
@@ -154,6 +158,8 @@ pgm_txw_retransmit_is_empty (
 static void pgm_txw_remove_tail (pgm_txw_t*const);
 static bool pgm_txw_retransmit_push_parity (pgm_txw_t*const, const uint32_t, const uint8_t);
 static bool pgm_txw_retransmit_push_selective (pgm_txw_t*const, const uint32_t);
+static void pgm_txw_parity_encode (pgm_txw_t*const restrict, const uint32_t, const uint8_t, const uint8_t, struct pgm_sk_buff_t**const restrict);
+static void pgm_txw_parity_fold (pgm_txw_t*const restrict, const struct pgm_sk_buff_t*const restrict);
 
 
 /* constructor for transmit window.  zero-length windows are not permitted.
@@ -171,7 +177,11 @@ pgm_txw_create (
 	const ssize_t		max_rte,	/* max bandwidth */
 	const bool		use_fec,
 	const uint8_t		rs_n,
-	const uint8_t		rs_k
+	const uint8_t		rs_k,
+	const uint8_t		rs_proactive_h,	/* parity packets encoded per transmission group */
+	const bool		rs_is_cauchy,	/* Cauchy generator matrix */
+	const size_t		page_size,	/* huge page size, 0 for heap */
+	const bool		use_mlock
 	)
 {
 	pgm_txw_t* window;
@@ -192,18 +202,29 @@ pgm_txw_create (
 	if (use_fec) {
 		pgm_assert_cmpuint (rs_n, >, 0);
 		pgm_assert_cmpuint (rs_k, >, 0);
+		pgm_assert_cmpuint (rs_proactive_h, <=, rs_n - rs_k);
+	} else {
+		pgm_assert_cmpuint (rs_proactive_h, ==, 0);
 	}
 
-	pgm_debug ("create (tsi:%s max-tpdu:%" PRIu16 " sqns:%" PRIu32  " secs %u max-rte %" PRIzd " use-fec:%s rs(n):%u rs(k):%u)",
+	pgm_debug ("create (tsi:%s max-tpdu:%" PRIu16 " sqns:%" PRIu32  " secs %u max-rte %" PRIzd " use-fec:%s rs(n):%u rs(k):%u rs(h):%u rs-cauchy:%s page-size:%" PRIzu " use-mlock:%s)",
 		pgm_tsi_print (tsi),
 		tpdu_size, sqns, secs, max_rte,
 		use_fec ? "YES" : "NO",
-		rs_n, rs_k);
+		rs_n, rs_k, rs_proactive_h,
+		rs_is_cauchy ? "YES" : "NO",
+		page_size,
+		use_mlock ? "YES" : "NO");
 
 /* calculate transmit window parameters */
 	pgm_assert (sqns || (tpdu_size && secs && max_rte));
 	const unsigned alloc_sqns = sqns ? sqns : (unsigned)( (secs * max_rte) / tpdu_size );
-	window = pgm_malloc0 (sizeof(pgm_txw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ));
+	size_t len = sizeof(pgm_txw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) );
+	window = page_size ? pgm_mem_map (&len, page_size, use_mlock) : NULL;
+	if (NULL != window)
+		window->map_len = len;
+	else
+		window = pgm_malloc0 (len);
 	window->tsi = tsi;
 
 /* empty state for transmission group boundaries to align.
@@ -215,9 +236,18 @@ pgm_txw_create (
 
 /* reed-solomon forward error correction */
 	if (use_fec) {
-		window->parity_buffer = pgm_alloc_skb (tpdu_size);
+		window->parity_cache = pgm_new0 (struct pgm_sk_buff_t*, rs_n - rs_k);
+		if (rs_proactive_h) {
+			for (unsigned i = 0; i < PGM_TXW_PARITY_TGS; i++)
+				window->proactive[i].skb = pgm_new0 (struct pgm_sk_buff_t*, rs_proactive_h);
+			window->rs_proactive_h = rs_proactive_h;
+			window->parity_acc_tsdu_length = pgm_new0 (uint16_t, rs_k);
+		}
 		window->tg_sqn_shift = pgm_power2_log2 (rs_k);
-		pgm_rs_create (&window->rs, rs_n, rs_k);
+		if (rs_is_cauchy)
+			pgm_rs_create_cauchy (&window->rs, rs_n, rs_k);
+		else
+			pgm_rs_create (&window->rs, rs_n, rs_k);
 		window->is_fec_enabled = 1;
 	}
 
@@ -266,12 +296,27 @@ pgm_txw_shutdown (
 
 /* free reed-solomon state */
 	if (window->is_fec_enabled) {
-		pgm_free_skb (window->parity_buffer);
+		for (uint_fast8_t i = 0; i < window->rs.n - window->rs.k; i++)
+			if (window->parity_cache[i])
+				pgm_free_skb (window->parity_cache[i]);
+		pgm_free (window->parity_cache);
+		if (window->rs_proactive_h) {
+			for (unsigned i = 0; i < PGM_TXW_PARITY_TGS; i++) {
+				for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++)
+					if (window->proactive[i].skb[j])
+						pgm_free_skb (window->proactive[i].skb[j]);
+				pgm_free (window->proactive[i].skb);
+			}
+			pgm_free (window->parity_acc_tsdu_length);
+		}
 		pgm_rs_destroy (&window->rs);
 	}
 
 /* window */
-	pgm_free (window);
+	if (window->map_len)
+		pgm_mem_unmap (window, window->map_len);
+	else
+		pgm_free (window);
 }
 
 /* add skb to transmit window, taking ownership.  window does not grow.
@@ -316,21 +361,271 @@ pgm_txw_add (
 	}
 
 /* generate new sequence number */
-	pgm_atomic_inc32 (&window->lead);
-	skb->sequence = window->lead;
+	skb->sequence = pgm_txw_next_lead (window);
 
-/* add skb to window */
+/* add skb to window before publishing the new lead so that readers using
+ * pgm_txw_lead_atomic() never see an unfilled slot.
+ */
 	const uint_fast32_t index_ = skb->sequence % pgm_txw_max_length (window);
 	window->pdata[index_] = skb;
+	pgm_atomic_inc32 (&window->lead);
 
 /* statistics */
 	window->size += skb->len;
 
+/* fold into the proactive parity packets of the open transmission group while
+ * the payload is still in cache.  the caller must hold the lock shared with
+ * the retransmit path at group boundaries, see pgm_txw_is_tg_boundary().
+ */
+	if (window->rs_proactive_h)
+		pgm_txw_parity_fold (window, skb);
+
 /* post-conditions */
 	pgm_assert_cmpuint (pgm_txw_length (window), >, 0);
 	pgm_assert_cmpuint (pgm_txw_length (window), <=, pgm_txw_max_length (window));
 }
 
+/* proactive parity packets are accumulated with the payload at a fixed offset
+ * leaving room for the largest header, which is only known when the group
+ * closes.
+ */
+
+#define PGM_TXW_PARITY_HEADER_MAX	(sizeof(struct pgm_header) + \
+					 sizeof(struct pgm_data) + \
+					 sizeof(struct pgm_opt_length) + \
+					 sizeof(struct pgm_opt_header) + \
+					 sizeof(struct pgm_opt_fragment))
+#define PGM_TXW_PARITY_OPT_OFFSET	(sizeof(struct pgm_header) + \
+					 sizeof(struct pgm_data) + \
+					 sizeof(struct pgm_opt_length) + \
+					 sizeof(struct pgm_opt_header) + \
+					 sizeof(struct pgm_opt_header))
+
+static inline
+pgm_gf8_t*
+_pgm_txw_parity_payload (
+	struct pgm_sk_buff_t* const skb
+	)
+{
+	return (pgm_gf8_t*)(skb + 1) + PGM_TXW_PARITY_HEADER_MAX;
+}
+
+/* start a transmission group, replacing the oldest group held.  parity
+ * packets still in transit keep their buffers and new ones are taken.
+ */
+
+static
+void
+pgm_txw_parity_begin (
+	pgm_txw_t*		    const restrict window,
+	struct pgm_txw_parity_t*    const restrict proactive,
+	const uint32_t				   tg_sqn,
+	const struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	const uint16_t size = (uint16_t)MIN(UINT16_MAX, PGM_TXW_PARITY_HEADER_MAX + ((char*)skb->end - (char*)skb->data) + sizeof(uint16_t));
+
+	proactive->is_valid = FALSE;
+	proactive->tg_sqn   = tg_sqn;
+	for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++)
+	{
+		struct pgm_sk_buff_t** parity_skb = &proactive->skb[ j ];
+		if (NULL != *parity_skb &&
+		    (1 != pgm_atomic_read32 (&(*parity_skb)->users) ||
+		     (char*)(*parity_skb)->end - (char*)(*parity_skb + 1) < size))
+		{
+			pgm_free_skb (*parity_skb);
+			*parity_skb = NULL;
+		}
+		if (NULL == *parity_skb)
+			*parity_skb = pgm_alloc_skb (size);
+		memset (*parity_skb + 1, 0, PGM_TXW_PARITY_HEADER_MAX);
+	}
+	window->parity_acc_len		 = 0;
+	window->parity_acc_is_var_pktlen = 0;
+	window->parity_acc_is_op_encoded = 0;
+}
+
+/* complete the PGM headers of the accumulated parity packets, to be finished
+ * by send_rdata(), and publish them to the retransmit path.
+ */
+
+static
+void
+pgm_txw_parity_close (
+	pgm_txw_t*		 const restrict window,
+	struct pgm_txw_parity_t* const restrict proactive
+	)
+{
+	struct pgm_sk_buff_t	 *skb;
+	pgm_gf8_t		**dst;
+	uint16_t		  parity_length = window->parity_acc_len;
+
+	dst = pgm_newa (pgm_gf8_t*, window->rs_proactive_h);
+
+/* append actual TSDU length if variable length packets */
+	if (window->parity_acc_is_var_pktlen)
+	{
+		for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++) {
+			dst[j] = _pgm_txw_parity_payload (proactive->skb[ j ]) + parity_length;
+			memset (dst[j], 0, sizeof(uint16_t));
+		}
+		for (uint_fast8_t i = 0; i < window->rs.k; i++)
+			pgm_rs_encode_fold (&window->rs,
+					    (const pgm_gf8_t*)&window->parity_acc_tsdu_length[ i ],
+					    i,
+					    window->rs.k,
+					    window->rs_proactive_h,
+					    dst,
+					    sizeof(uint16_t));
+		parity_length += 2;
+	}
+
+	const uint16_t opt_total_length = sizeof(struct pgm_opt_length) +
+					  sizeof(struct pgm_opt_header) +
+					  sizeof(struct pgm_opt_fragment);
+	const uint16_t header_length = sizeof(struct pgm_header) +
+				       sizeof(struct pgm_data) +
+				       (window->parity_acc_is_op_encoded ? opt_total_length : 0);
+
+	for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++)
+	{
+		pgm_gf8_t* payload = _pgm_txw_parity_payload (proactive->skb[ j ]);
+
+		skb = proactive->skb[ j ];
+		skb->head = skb->data	= payload - header_length;
+		skb->tail		= payload + parity_length;
+		skb->len		= header_length + parity_length;
+		skb->pgm_header		= skb->head;
+		skb->pgm_data		= (void*)( skb->pgm_header + 1 );
+		memcpy (skb->pgm_header->pgm_gsi, &window->tsi->gsi, sizeof(pgm_gsi_t));
+		skb->pgm_header->pgm_options = PGM_OPT_PARITY;
+		if (window->parity_acc_is_var_pktlen)
+			skb->pgm_header->pgm_options |= PGM_OPT_VAR_PKTLEN;
+		skb->pgm_header->pgm_tsdu_length = htons (parity_length);
+		skb->pgm_data->data_sqn	= htonl ( proactive->tg_sqn | j );
+
+/* options precede the payload, the encoded fragment is already in place */
+		if (window->parity_acc_is_op_encoded)
+		{
+			struct pgm_opt_header	*opt_header;
+			struct pgm_opt_length	*opt_len;
+
+			skb->pgm_header->pgm_options |= PGM_OPT_PRESENT;
+
+			opt_len					= (void*)( skb->pgm_data + 1 );
+			opt_len->opt_type			= PGM_OPT_LENGTH;
+			opt_len->opt_length			= sizeof(struct pgm_opt_length);
+			opt_len->opt_total_length		= htons ( opt_total_length );
+			opt_header			 	= (struct pgm_opt_header*)(opt_len + 1);
+			opt_header->opt_type			= PGM_OPT_FRAGMENT | PGM_OPT_END;
+			opt_header->opt_length			= sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_fragment);
+			opt_header->opt_reserved 		= PGM_OP_ENCODED;
+		}
+
+		pgm_txw_set_unfolded_checksum (skb, pgm_csum_partial (payload, parity_length, 0));
+	}
+
+	proactive->is_valid = TRUE;
+}
+
+/* fold an original data packet into the proactive parity packets of its
+ * transmission group, opening the group on the first packet and closing it
+ * on the last.
+ */
+
+static
+void
+pgm_txw_parity_fold (
+	pgm_txw_t*		    const restrict window,
+	const struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	struct pgm_txw_parity_t	 *proactive;
+	struct pgm_opt_fragment	  null_opt_fragment;
+	const pgm_gf8_t		 *opt_src;
+	pgm_gf8_t		**dst;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (window->rs_proactive_h > 0);
+	pgm_assert (NULL != skb);
+
+	const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
+	const uint32_t tg_sqn = skb->sequence & tg_sqn_mask;
+	const uint8_t  index_ = (uint8_t)(skb->sequence & ~tg_sqn_mask);
+	const uint16_t tsdu_length = ntohs (skb->pgm_header->pgm_tsdu_length);
+
+	proactive = &window->proactive[ (tg_sqn >> window->tg_sqn_shift) % PGM_TXW_PARITY_TGS ];
+	if (0 == index_)
+		pgm_txw_parity_begin (window, proactive, tg_sqn, skb);
+	pgm_assert (proactive->tg_sqn == tg_sqn);
+	pgm_assert (!proactive->is_valid);
+
+	dst = pgm_newa (pgm_gf8_t*, window->rs_proactive_h);
+
+/* grow buffers to the longest TSDU, zero padding shorter packets */
+	if (tsdu_length > window->parity_acc_len)
+	{
+		const uint16_t size = (uint16_t)MIN(UINT16_MAX, PGM_TXW_PARITY_HEADER_MAX + tsdu_length + sizeof(uint16_t));
+		for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++)
+		{
+			struct pgm_sk_buff_t* parity_skb = proactive->skb[ j ];
+			if ((char*)parity_skb->end - (char*)(parity_skb + 1) < size) {
+				proactive->skb[ j ] = pgm_alloc_skb (size);
+				memcpy (proactive->skb[ j ] + 1, parity_skb + 1, PGM_TXW_PARITY_HEADER_MAX + window->parity_acc_len);
+				pgm_free_skb (parity_skb);
+			}
+			memset (_pgm_txw_parity_payload (proactive->skb[ j ]) + window->parity_acc_len,
+				0,
+				tsdu_length - window->parity_acc_len);
+		}
+	}
+	if (index_ > 0 && tsdu_length != window->parity_acc_len)
+		window->parity_acc_is_var_pktlen = 1;
+	if (tsdu_length > window->parity_acc_len)
+		window->parity_acc_len = tsdu_length;
+	window->parity_acc_tsdu_length[ index_ ] = tsdu_length;
+
+/* encode payload */
+	for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++)
+		dst[j] = _pgm_txw_parity_payload (proactive->skb[ j ]);
+	pgm_rs_encode_fold (&window->rs,
+			    skb->data,
+			    index_,
+			    window->rs.k,
+			    window->rs_proactive_h,
+			    dst,
+			    tsdu_length);
+
+/* encode opt_fragment, null fragment when absent */
+	if (skb->pgm_header->pgm_options & PGM_OPT_PRESENT)
+		window->parity_acc_is_op_encoded = 1;
+	if (skb->pgm_opt_fragment)
+	{
+/* skip three bytes of header */
+		opt_src = (const pgm_gf8_t*)((const char*)skb->pgm_opt_fragment + sizeof (struct pgm_opt_header));
+	}
+	else
+	{
+		memset (&null_opt_fragment, 0, sizeof(null_opt_fragment));
+		*(uint8_t*)&null_opt_fragment |= PGM_OP_ENCODED_NULL;
+		opt_src = (const pgm_gf8_t*)&null_opt_fragment;
+	}
+	for (uint_fast8_t j = 0; j < window->rs_proactive_h; j++)
+		dst[j] = (pgm_gf8_t*)(proactive->skb[ j ] + 1) + PGM_TXW_PARITY_OPT_OFFSET;
+	pgm_rs_encode_fold (&window->rs,
+			    opt_src,
+			    index_,
+			    window->rs.k,
+			    window->rs_proactive_h,
+			    dst,
+			    sizeof(struct pgm_opt_fragment) - sizeof(struct pgm_opt_header));
+
+	if (window->rs.k - 1 == index_)
+		pgm_txw_parity_close (window, proactive);
+}
+
 /* peek an entry from the window for retransmission.
  *
  * returns pointer to skbuff on success, returns NULL on invalid parameters.
@@ -377,6 +672,20 @@ pgm_txw_remove_tail (
 		state->waiting_retransmit = 0;
 	}
 
+/* parity packets are no longer valid once the transmission group leaves the window */
+	const uint32_t tg_sqn = skb->sequence & (0xffffffff << window->tg_sqn_shift);
+	if (window->parity_cnt &&
+	    window->parity_tg_sqn == tg_sqn)
+	{
+		window->parity_cnt = 0;
+	}
+	if (window->rs_proactive_h)
+	{
+		struct pgm_txw_parity_t* proactive = &window->proactive[ (tg_sqn >> window->tg_sqn_shift) % PGM_TXW_PARITY_TGS ];
+		if (proactive->tg_sqn == tg_sqn)
+			proactive->is_valid = FALSE;
+	}
+
 /* statistics */
 	window->size -= skb->len;
 	if (state->retransmit_count > 0) {
@@ -538,59 +847,40 @@ pgm_txw_retransmit_push_selective (
 	return TRUE;
 }
 
-/* try to peek a request from the retransmit queue
- *
- * return pointer of first skb in queue, or return NULL if the queue is empty.
+/* encode count consecutive parity packets of a transmission group starting at
+ * index rs_h, into the parity skb vector which is (re)allocated as necessary.
+ * the partial checksum of each parity packet is stored in its own control
+ * buffer for send_rdata().
  */
 
-PGM_GNUC_INTERNAL
-struct pgm_sk_buff_t*
-pgm_txw_retransmit_try_peek (
-	pgm_txw_t* const	window
+static
+void
+pgm_txw_parity_encode (
+	pgm_txw_t*	      const restrict window,
+	const uint32_t			     tg_sqn,
+	const uint8_t			     rs_h,
+	const uint8_t			     count,
+	struct pgm_sk_buff_t**const restrict parity		/* length count */
 	)
 {
 	struct pgm_sk_buff_t	 *skb;
-	pgm_txw_state_t		 *state;
 	bool			  is_var_pktlen = FALSE;
 	bool			  is_op_encoded = FALSE;
 	uint16_t		  parity_length = 0;
 	const pgm_gf8_t		**src;
+	pgm_gf8_t		**dst, **opt_dst;
 	void			 *data;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
+	pgm_assert (count > 0);
+	pgm_assert (rs_h + count <= window->rs.n - window->rs.k);
+	pgm_assert (NULL != parity);
 
 	src = pgm_newa (const pgm_gf8_t*, window->rs.k);
+	dst = pgm_newa (pgm_gf8_t*, count);
+	opt_dst = pgm_newa (pgm_gf8_t*, count);
 
-	pgm_debug ("retransmit_try_peek (window:%p)", (const void*)window);
-
-/* no lock required to detect presence of a request */
-	skb = (struct pgm_sk_buff_t*)pgm_queue_peek_tail_link (&window->retransmit_queue);
-	if (PGM_UNLIKELY(NULL == skb)) {
-		pgm_debug ("retransmit queue empty on peek.");
-		return NULL;
-	}
-
-	pgm_assert (pgm_skb_is_valid (skb));
-	state = (pgm_txw_state_t*)&skb->cb;
-
-	if (!state->waiting_retransmit) {
-		pgm_assert (((const pgm_list_t*)skb)->next == NULL);
-		pgm_assert (((const pgm_list_t*)skb)->prev == NULL);
-	}
-/* packet payload still in transit */
-	if (PGM_UNLIKELY(1 != pgm_atomic_read32 (&skb->users))) {
-		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Retransmit sqn #%" PRIu32 " is still in transit in transmit thread."), skb->sequence);
-		return NULL;
-	}
-	if (!state->pkt_cnt_requested) {
-		return skb;
-	}
-
-/* generate parity packet to satisify request */	
-	const uint8_t rs_h = state->pkt_cnt_sent % (window->rs.n - window->rs.k);
-	const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
-	const uint32_t tg_sqn = skb->sequence & tg_sqn_mask;
 	for (uint_fast8_t i = 0; i < window->rs.k; i++)
 	{
 		const struct pgm_sk_buff_t* odata_skb = pgm_txw_peek (window, tg_sqn + i);
@@ -612,24 +902,10 @@ pgm_txw_retransmit_try_peek (
 		}
 	}
 
-/* construct basic PGM header to be completed by send_rdata() */
-	skb = window->parity_buffer;
-	skb->data = skb->tail = skb->head = skb + 1;
-
-/* space for PGM header */
-	pgm_skb_put (skb, sizeof(struct pgm_header));
-
-	skb->pgm_header		= skb->data;
-	skb->pgm_data		= (void*)( skb->pgm_header + 1 );
-	memcpy (skb->pgm_header->pgm_gsi, &window->tsi->gsi, sizeof(pgm_gsi_t));
-	skb->pgm_header->pgm_options = PGM_OPT_PARITY;
-
 /* append actual TSDU length if variable length packets, zero pad as necessary.
  */
 	if (is_var_pktlen)
 	{
-		skb->pgm_header->pgm_options |= PGM_OPT_VAR_PKTLEN;
-
 		for (uint_fast8_t i = 0; i < window->rs.k; i++)
 		{
 			struct pgm_sk_buff_t* odata_skb = pgm_txw_peek (window, tg_sqn + i);
@@ -647,26 +923,94 @@ pgm_txw_retransmit_try_peek (
 		parity_length += 2;
 	}
 
-	skb->pgm_header->pgm_tsdu_length = htons (parity_length);
+	const uint16_t opt_total_length = sizeof(struct pgm_opt_length) +
+					 sizeof(struct pgm_opt_header) +
+					 sizeof(struct pgm_opt_fragment);
+	const uint16_t tpdu_length = sizeof(struct pgm_header) +
+				     sizeof(struct pgm_data) +
+				     (is_op_encoded ? opt_total_length : 0) +
+				     parity_length;
+
+/* construct basic PGM header to be completed by send_rdata() */
+	for (uint_fast8_t j = 0; j < count; j++)
+	{
+		struct pgm_sk_buff_t** parity_skb = &parity[ j ];
+
+/* sized to the largest transmission group seen, a packet still in transit
+ * keeps its buffer and a new one is taken.
+ */
+		if (NULL != *parity_skb &&
+		    (1 != pgm_atomic_read32 (&(*parity_skb)->users) ||
+		     (char*)(*parity_skb)->end - (char*)(*parity_skb)->head < tpdu_length))
+		{
+			pgm_free_skb (*parity_skb);
+			*parity_skb = NULL;
+		}
+		if (NULL == *parity_skb)
+			*parity_skb = pgm_alloc_skb (tpdu_length);
+
+		skb = *parity_skb;
+		skb->data = skb->tail = skb->head = skb + 1;
+		skb->len = 0;
+
+/* space for PGM header */
+		pgm_skb_put (skb, sizeof(struct pgm_header));
+
+		skb->pgm_header		= skb->data;
+		skb->pgm_data		= (void*)( skb->pgm_header + 1 );
+		memcpy (skb->pgm_header->pgm_gsi, &window->tsi->gsi, sizeof(pgm_gsi_t));
+		skb->pgm_header->pgm_options = PGM_OPT_PARITY;
+		if (is_var_pktlen)
+			skb->pgm_header->pgm_options |= PGM_OPT_VAR_PKTLEN;
+		skb->pgm_header->pgm_tsdu_length = htons (parity_length);
 
 /* space for DATA */
-	pgm_skb_put (skb, sizeof(struct pgm_data) + parity_length);
+		pgm_skb_put (skb, sizeof(struct pgm_data) + parity_length);
+
+		skb->pgm_data->data_sqn	= htonl ( tg_sqn | (rs_h + j) );
+
+		data = skb->pgm_data + 1;
+
+/* add options to this rdata packet */
+		if (is_op_encoded)
+		{
+			struct pgm_opt_header	*opt_header;
+			struct pgm_opt_length	*opt_len;
+			struct pgm_opt_fragment	*opt_fragment;
+
+			skb->pgm_header->pgm_options |= PGM_OPT_PRESENT;
 
-	skb->pgm_data->data_sqn	= htonl ( tg_sqn | rs_h );
+/* add space for PGM options */
+			pgm_skb_put (skb, opt_total_length);
+
+			opt_len					= data;
+			opt_len->opt_type			= PGM_OPT_LENGTH;
+			opt_len->opt_length			= sizeof(struct pgm_opt_length);
+			opt_len->opt_total_length		= htons ( opt_total_length );
+			opt_header			 	= (struct pgm_opt_header*)(opt_len + 1);
+			opt_header->opt_type			= PGM_OPT_FRAGMENT | PGM_OPT_END;
+			opt_header->opt_length			= sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_fragment);
+			opt_header->opt_reserved 		= PGM_OP_ENCODED;
+			opt_fragment				= (struct pgm_opt_fragment*)(opt_header + 1);
 
-	data = skb->pgm_data + 1;
+/* The cast below is the correct way to handle the problem. 
+ * The (void *) cast is to avoid a GCC warning like: 
+ *
+ *   "warning: dereferencing type-punned pointer will break strict-aliasing rules"
+ */
+			opt_dst[j] = (pgm_gf8_t*)((char*)opt_fragment + sizeof(struct pgm_opt_header));
+			data = opt_fragment + 1;
+		}
+		dst[j] = data;
+	}
 
 /* encode every option separately, currently only one applies: opt_fragment
  */
 	if (is_op_encoded)
 	{
-		struct pgm_opt_header	*opt_header;
-		struct pgm_opt_length	*opt_len;
-		struct pgm_opt_fragment	*opt_fragment, null_opt_fragment;
+		struct pgm_opt_fragment	 null_opt_fragment;
 		const pgm_gf8_t		*opt_src[ window->rs.k ];
 
-		skb->pgm_header->pgm_options |= PGM_OPT_PRESENT;
-
 		memset (&null_opt_fragment, 0, sizeof(null_opt_fragment));
 		*(uint8_t*)&null_opt_fragment |= PGM_OP_ENCODED_NULL;
 
@@ -686,49 +1030,106 @@ pgm_txw_retransmit_try_peek (
 			}
 		}
 
-/* add options to this rdata packet */
-		const uint16_t opt_total_length = sizeof(struct pgm_opt_length) +
-						 sizeof(struct pgm_opt_header) +
-						 sizeof(struct pgm_opt_fragment);
+		pgm_rs_encode_multi (&window->rs,
+				     opt_src,
+				     window->rs.k + rs_h,
+				     count,
+				     opt_dst,
+				     sizeof(struct pgm_opt_fragment) - sizeof(struct pgm_opt_header));
+	}
 
-/* add space for PGM options */
-		pgm_skb_put (skb, opt_total_length);
-
-		opt_len					= data;
-		opt_len->opt_type			= PGM_OPT_LENGTH;
-		opt_len->opt_length			= sizeof(struct pgm_opt_length);
-		opt_len->opt_total_length		= htons ( opt_total_length );
-		opt_header			 	= (struct pgm_opt_header*)(opt_len + 1);
-		opt_header->opt_type			= PGM_OPT_FRAGMENT | PGM_OPT_END;
-		opt_header->opt_length			= sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_fragment);
-		opt_header->opt_reserved 		= PGM_OP_ENCODED;
-		opt_fragment				= (struct pgm_opt_fragment*)(opt_header + 1);
+/* encode payload */
+	pgm_rs_encode_multi (&window->rs,
+			     src,
+			     window->rs.k + rs_h,
+			     count,
+			     dst,
+			     parity_length);
+
+/* calculate partial checksum, stored with each parity packet as send_rdata() reads the
+ * checksum from the packet it transmits.
+ */
+	for (uint_fast8_t j = 0; j < count; j++)
+	{
+		skb = parity[ j ];
+		pgm_txw_set_unfolded_checksum (skb, pgm_csum_partial ((char*)skb->tail - parity_length, parity_length, 0));
+	}
+}
 
-/* The cast below is the correct way to handle the problem. 
- * The (void *) cast is to avoid a GCC warning like: 
+/* try to peek a request from the retransmit queue
  *
- *   "warning: dereferencing type-punned pointer will break strict-aliasing rules"
+ * return pointer of first skb in queue, or return NULL if the queue is empty.
  */
-		pgm_rs_encode (&window->rs,
-				opt_src,
-				window->rs.k + rs_h,
-				(pgm_gf8_t*)((char*)opt_fragment + sizeof(struct pgm_opt_header)),
-				sizeof(struct pgm_opt_fragment) - sizeof(struct pgm_opt_header));
 
-		data = opt_fragment + 1;
+PGM_GNUC_INTERNAL
+struct pgm_sk_buff_t*
+pgm_txw_retransmit_try_peek (
+	pgm_txw_t* const	window
+	)
+{
+	struct pgm_sk_buff_t	*skb;
+	pgm_txw_state_t		*state;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+
+	pgm_debug ("retransmit_try_peek (window:%p)", (const void*)window);
+
+/* no lock required to detect presence of a request */
+	skb = (struct pgm_sk_buff_t*)pgm_queue_peek_tail_link (&window->retransmit_queue);
+	if (PGM_UNLIKELY(NULL == skb)) {
+		pgm_debug ("retransmit queue empty on peek.");
+		return NULL;
 	}
 
-/* encode payload */
-	pgm_rs_encode (&window->rs,
-			src,
-			window->rs.k + rs_h,
-			data,
-			parity_length);
+	pgm_assert (pgm_skb_is_valid (skb));
+	state = (pgm_txw_state_t*)&skb->cb;
 
-/* calculate partial checksum */
-	const uint16_t tsdu_length = ntohs (skb->pgm_header->pgm_tsdu_length);
-	state->unfolded_checksum = pgm_csum_partial ((char*)skb->tail - tsdu_length, tsdu_length, 0);
-	return skb;
+	if (!state->waiting_retransmit) {
+		pgm_assert (((const pgm_list_t*)skb)->next == NULL);
+		pgm_assert (((const pgm_list_t*)skb)->prev == NULL);
+	}
+/* packet payload still in transit */
+	if (PGM_UNLIKELY(1 != pgm_atomic_read32 (&skb->users))) {
+		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Retransmit sqn #%" PRIu32 " is still in transit in transmit thread."), skb->sequence);
+		return NULL;
+	}
+	if (!state->pkt_cnt_requested) {
+		return skb;
+	}
+
+/* generate parity packets to satisify request */	
+	const uint8_t rs_h = state->pkt_cnt_sent % (window->rs.n - window->rs.k);
+	const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
+	const uint32_t tg_sqn = skb->sequence & tg_sqn_mask;
+
+/* encoded when the transmission group closed */
+	if (rs_h < window->rs_proactive_h)
+	{
+		const struct pgm_txw_parity_t* proactive = &window->proactive[ (tg_sqn >> window->tg_sqn_shift) % PGM_TXW_PARITY_TGS ];
+		if (proactive->is_valid && proactive->tg_sqn == tg_sqn)
+			return proactive->skb[ rs_h ];
+	}
+
+/* encoded in an earlier pass for this transmission group */
+	if (window->parity_cnt &&
+	    window->parity_tg_sqn == tg_sqn &&
+	    rs_h >= window->parity_first &&
+	    rs_h < window->parity_first + window->parity_cnt)
+	{
+		return window->parity_cache[ rs_h ];
+	}
+
+/* encode all outstanding parity packets of the request in one pass */
+	const uint8_t parity_cnt = (uint8_t)MAX(1, MIN(state->pkt_cnt_requested - state->pkt_cnt_sent,
+						       (window->rs.n - window->rs.k) - rs_h));
+	window->parity_cnt = 0;
+	pgm_txw_parity_encode (window, tg_sqn, rs_h, parity_cnt, &window->parity_cache[ rs_h ]);
+
+	window->parity_tg_sqn	= tg_sqn;
+	window->parity_first	= rs_h;
+	window->parity_cnt	= parity_cnt;
+	return window->parity_cache[ rs_h ];
 }
 
 /* remove head entry from retransmit queue, will fail on assertion if queue is empty.
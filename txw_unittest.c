@@ -35,8 +35,10 @@
 
 #define pgm_histogram_add		mock_pgm_histogram_add
 #define pgm_rs_create			mock_pgm_rs_create
+#define pgm_rs_create_cauchy		mock_pgm_rs_create
 #define pgm_rs_destroy			mock_pgm_rs_destroy
-#define pgm_rs_encode			mock_pgm_rs_encode
+#define pgm_rs_encode_multi		mock_pgm_rs_encode_multi
+#define pgm_rs_encode_fold		mock_pgm_rs_encode_fold
 #define pgm_compat_csum_partial		mock_pgm_compat_csum_partial
 #define pgm_histogram_init		mock_pgm_histogram_init
 
@@ -52,6 +54,8 @@ mock_pgm_rs_create (
 	uint8_t			k
 	)
 {
+	rs->n = n;
+	rs->k = k;
 }
 
 void
@@ -62,11 +66,25 @@ mock_pgm_rs_destroy (
 }
 
 void
-mock_pgm_rs_encode(
+mock_pgm_rs_encode_fold (
+	pgm_rs_t*		rs,
+	const pgm_gf8_t*	src,
+	const uint8_t		index,
+	const uint8_t		offset,
+	const uint8_t		count,
+	pgm_gf8_t**		dst,
+	const uint16_t		len
+        )
+{
+}
+
+void
+mock_pgm_rs_encode_multi (
 	pgm_rs_t*		rs,
 	const pgm_gf8_t**	src,
 	const uint8_t		offset,
-	pgm_gf8_t*		dst,
+	const uint8_t		count,
+	pgm_gf8_t**		dst,
 	const uint16_t		len
         )
 {
@@ -151,7 +169,11 @@ generate_valid_skb (void)
  *		const guint		max_rte,
  *		const gboolean		use_fec,
  *		const guint		rs_n,
- *		const guint		rs_k
+ *		const guint		rs_k,
+ *		const guint		rs_proactive_h,
+ *		const gboolean		rs_is_cauchy,
+ *		const gsize		page_size,
+ *		const gboolean		use_mlock
  *		)
  */
 
@@ -159,7 +181,7 @@ generate_valid_skb (void)
 START_TEST (test_create_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE), "create failed");
 }
 END_TEST
 
@@ -167,7 +189,7 @@ END_TEST
 START_TEST (test_create_pass_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, 1500, 0, 60, 800000, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, 1500, 0, 60, 800000, FALSE, 0, 0, 0, FALSE, 0, FALSE), "create failed");
 }
 END_TEST
 
@@ -175,7 +197,7 @@ END_TEST
 START_TEST (test_create_pass_003)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, 9000, 0, 60, 800000, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, 9000, 0, 60, 800000, FALSE, 0, 0, 0, FALSE, 0, FALSE), "create failed");
 }
 END_TEST
 
@@ -183,7 +205,17 @@ END_TEST
 START_TEST (test_create_pass_004)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, UINT16_MAX, 0, 60, 800000, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, UINT16_MAX, 0, 60, 800000, FALSE, 0, 0, 0, FALSE, 0, FALSE), "create failed");
+}
+END_TEST
+
+/* huge page backed, normal pages when none reserved */
+START_TEST (test_create_pass_005)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 2 * 1024 * 1024, FALSE);
+	fail_if (NULL == window, "create failed");
+	fail_unless (window->map_len > 0, "not mapped");
 }
 END_TEST
 
@@ -191,7 +223,7 @@ END_TEST
 START_TEST (test_create_fail_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 800000, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 800000, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail ("reached");
 }
 END_TEST
@@ -200,7 +232,7 @@ END_TEST
 START_TEST (test_create_fail_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 0, 800000, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 0, 800000, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail ("reached");
 }
 END_TEST
@@ -209,7 +241,7 @@ END_TEST
 START_TEST (test_create_fail_003)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 0, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail ("reached");
 }
 END_TEST
@@ -218,7 +250,7 @@ END_TEST
 START_TEST (test_create_fail_004)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (NULL, 0, 0, 0, 0, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (NULL, 0, 0, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail ("reached");
 }
 END_TEST
@@ -233,7 +265,16 @@ END_TEST
 START_TEST (test_shutdown_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
+	fail_if (NULL == window, "create failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+START_TEST (test_shutdown_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 2 * 1024 * 1024, TRUE);
 	fail_if (NULL == window, "create failed");
 	pgm_txw_shutdown (window);
 }
@@ -258,7 +299,7 @@ END_TEST
 START_TEST (test_add_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -267,11 +308,31 @@ START_TEST (test_add_pass_001)
 }
 END_TEST
 
+/* proactive parity encoded as the transmission group closes */
+START_TEST (test_add_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, TRUE, 255, 4, 2, FALSE, 0, FALSE);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 4; i++) {
+		fail_if (window->proactive[0].is_valid, "parity encoded early");
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		pgm_txw_add (window, skb);
+	}
+	fail_unless (window->proactive[0].is_valid, "parity not encoded");
+	fail_if (NULL == window->proactive[0].skb[1], "parity not encoded");
+	fail_unless (1 == pgm_txw_retransmit_push (window, 1, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	fail_unless (window->proactive[0].skb[0] == pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
 /* null skb */
 START_TEST (test_add_fail_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	pgm_txw_add (window, NULL);
 	fail ("reached");
@@ -292,7 +353,7 @@ END_TEST
 START_TEST (test_add_fail_003)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	char buffer[1500];
 	memset (buffer, 0, sizeof(buffer));
@@ -312,7 +373,7 @@ END_TEST
 START_TEST (test_peek_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -334,7 +395,7 @@ END_TEST
 START_TEST (test_peek_fail_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	fail_unless (NULL == pgm_txw_peek (window, window->trail), "peek failed");
 	pgm_txw_shutdown (window);
@@ -348,7 +409,7 @@ START_TEST (test_max_length_pass_001)
 {
 	const guint window_length = 100;
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	fail_unless (window_length == pgm_txw_max_length (window), "max_length failed");
 	pgm_txw_shutdown (window);
@@ -367,7 +428,7 @@ END_TEST
 START_TEST (test_length_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	fail_unless (0 == pgm_txw_length (window), "length failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -390,7 +451,7 @@ END_TEST
 START_TEST (test_size_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	fail_unless (0 == pgm_txw_size (window), "size failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -413,7 +474,7 @@ END_TEST
 START_TEST (test_is_empty_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	fail_unless (pgm_txw_is_empty (window), "is_empty failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -436,7 +497,7 @@ END_TEST
 START_TEST (test_is_full_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	fail_if (pgm_txw_is_full (window), "is_full failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -459,7 +520,7 @@ END_TEST
 START_TEST (test_lead_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	guint32 lead = pgm_txw_lead (window);
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -483,7 +544,7 @@ START_TEST (test_next_lead_pass_001)
 {
 	const guint window_length = 100;
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	guint32 next_lead = pgm_txw_next_lead (window);
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -506,7 +567,7 @@ END_TEST
 START_TEST (test_trail_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 /* does not advance with adding skb */
 	guint32 trail = pgm_txw_trail (window);
@@ -543,7 +604,7 @@ END_TEST
 START_TEST (test_retransmit_push_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 /* empty window invalidates all requests */
 	fail_unless (FALSE == pgm_txw_retransmit_push (window, window->trail, FALSE, 0), "retransmit_push failed");
@@ -575,7 +636,7 @@ END_TEST
 START_TEST (test_retransmit_try_peek_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -604,7 +665,7 @@ END_TEST
 START_TEST (test_retransmit_remove_head_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -628,7 +689,7 @@ END_TEST
 START_TEST (test_retransmit_remove_head_fail_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 0, FALSE, 0, FALSE);
 	fail_if (NULL == window, "create failed");
 	pgm_txw_retransmit_remove_head (window);
 	fail ("reached");
@@ -649,6 +710,7 @@ make_test_suite (void)
 	tcase_add_test (tc_create, test_create_pass_002);
 	tcase_add_test (tc_create, test_create_pass_003);
 	tcase_add_test (tc_create, test_create_pass_004);
+	tcase_add_test (tc_create, test_create_pass_005);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
 	tcase_add_test_raise_signal (tc_create, test_create_fail_002, SIGABRT);
@@ -659,6 +721,7 @@ make_test_suite (void)
 	TCase* tc_shutdown = tcase_create ("shutdown");
 	suite_add_tcase (s, tc_shutdown);
 	tcase_add_test (tc_shutdown, test_shutdown_pass_001);
+	tcase_add_test (tc_shutdown, test_shutdown_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_shutdown, test_shutdown_fail_001, SIGABRT);
 #endif
@@ -666,6 +729,7 @@ make_test_suite (void)
 	TCase* tc_add = tcase_create ("add");
 	suite_add_tcase (s, tc_add);
 	tcase_add_test (tc_add, test_add_pass_001);
+	tcase_add_test (tc_add, test_add_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_add, test_add_fail_001, SIGABRT);
 	tcase_add_test_raise_signal (tc_add, test_add_fail_002, SIGABRT);
@@ -0,0 +1,266 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * io_uring asynchronous receive ring.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <errno.h>
+#ifdef HAVE_LINUX_IO_URING_H
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	include <linux/io_uring.h>
+#endif
+#include <impl/framework.h>
+#include <impl/uring.h>
+
+
+//#define URING_DEBUG
+
+#ifdef HAVE_LINUX_IO_URING_H
+
+/* the rings are shared with the kernel: tail and head indices are published
+ * with release semantics and observed with acquire semantics.
+ */
+
+#define pgm_uring_load_acquire(p)	__atomic_load_n ((p), __ATOMIC_ACQUIRE)
+#define pgm_uring_store_release(p,v)	__atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+
+/* create an io_uring instance with at least entries submission slots,
+ * completion queue is sized by the kernel at twice that.
+ *
+ * returns new ring on success, returns NULL on error and sets errno, e.g.
+ * ENOSYS on kernels without io_uring, EPERM when disabled by policy.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_uring_t*
+pgm_uring_create (
+	unsigned	entries
+	)
+{
+	struct io_uring_params p;
+	pgm_uring_t* uring;
+	int save_errno;
+
+/* pre-conditions */
+	pgm_assert (entries > 0);
+
+	memset (&p, 0, sizeof(p));
+	const int fd = (int)syscall (__NR_io_uring_setup, entries, &p);
+	if (fd < 0)
+		return NULL;
+
+	uring = pgm_new0 (pgm_uring_t, 1);
+	uring->fd		= fd;
+	uring->sq_ring_size	= p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	uring->cq_ring_size	= p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	uring->sqes_size	= p.sq_entries * sizeof(struct io_uring_sqe);
+
+/* single mapping for both rings when supported */
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (uring->cq_ring_size > uring->sq_ring_size)
+			uring->sq_ring_size = uring->cq_ring_size;
+		uring->cq_ring_size = uring->sq_ring_size;
+	}
+	uring->sq_ring = mmap (NULL, uring->sq_ring_size, PROT_READ | PROT_WRITE,
+			       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (MAP_FAILED == uring->sq_ring)
+		goto err_close;
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		uring->cq_ring = uring->sq_ring;
+	} else {
+		uring->cq_ring = mmap (NULL, uring->cq_ring_size, PROT_READ | PROT_WRITE,
+				       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (MAP_FAILED == uring->cq_ring)
+			goto err_sq;
+	}
+	uring->sqes = mmap (NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (MAP_FAILED == uring->sqes)
+		goto err_cq;
+
+	char* sq = uring->sq_ring;
+	char* cq = uring->cq_ring;
+	uring->sq_head	= (unsigned*)(sq + p.sq_off.head);
+	uring->sq_tail	= (unsigned*)(sq + p.sq_off.tail);
+	uring->sq_mask	= (unsigned*)(sq + p.sq_off.ring_mask);
+	uring->sq_array	= (unsigned*)(sq + p.sq_off.array);
+	uring->cq_head	= (unsigned*)(cq + p.cq_off.head);
+	uring->cq_tail	= (unsigned*)(cq + p.cq_off.tail);
+	uring->cq_mask	= (unsigned*)(cq + p.cq_off.ring_mask);
+	uring->cqes	= (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+	return uring;
+
+err_cq:
+	save_errno = errno;
+	if (uring->cq_ring != uring->sq_ring)
+		munmap (uring->cq_ring, uring->cq_ring_size);
+	errno = save_errno;
+err_sq:
+	save_errno = errno;
+	munmap (uring->sq_ring, uring->sq_ring_size);
+	errno = save_errno;
+err_close:
+	save_errno = errno;
+	close (fd);
+	pgm_free (uring);
+	errno = save_errno;
+	return NULL;
+}
+
+/* release ring, closing the descriptor cancels any requests in flight.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_uring_destroy (
+	pgm_uring_t*	uring
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != uring);
+
+	munmap (uring->sqes, uring->sqes_size);
+	if (uring->cq_ring != uring->sq_ring)
+		munmap (uring->cq_ring, uring->cq_ring_size);
+	munmap (uring->sq_ring, uring->sq_ring_size);
+	close (uring->fd);
+	pgm_free (uring);
+}
+
+/* queue a recvmsg request reading one TPDU into a receive ring slot, the
+ * slot index is returned as the completion user data.  the message header
+ * lives in the slot as the kernel references it until completion.
+ *
+ * returns TRUE on success, returns FALSE if the submission queue is full.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_uring_recv_slot (
+	pgm_uring_t*	      restrict uring,
+	const SOCKET		       s,
+	struct pgm_rx_slot_t* restrict slot,
+	const unsigned		       index,
+	const size_t		       len
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != uring);
+	pgm_assert (NULL != slot);
+	pgm_assert (NULL != slot->skb);
+
+	const unsigned head = pgm_uring_load_acquire (uring->sq_head);
+	const unsigned tail = *uring->sq_tail;
+	const unsigned mask = *uring->sq_mask;
+	if (PGM_UNLIKELY(tail - head > mask))
+		return FALSE;
+
+	slot->iov.iov_base		= slot->skb->head;
+	slot->iov.iov_len		= len;
+	memset (&slot->msg, 0, sizeof(slot->msg));
+	slot->msg.msg_name		= &slot->src_addr;
+	slot->msg.msg_namelen		= sizeof(slot->src_addr);
+	slot->msg.msg_iov		= (void*)&slot->iov;
+	slot->msg.msg_iovlen		= 1;
+	slot->msg.msg_control		= slot->aux;
+	slot->msg.msg_controllen	= sizeof(slot->aux);
+
+	struct io_uring_sqe* sqe = &uring->sqes[ tail & mask ];
+	memset (sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode		= IORING_OP_RECVMSG;
+	sqe->fd			= s;
+	sqe->addr		= (uintptr_t)&slot->msg;
+	sqe->len		= 1;
+	sqe->user_data		= index;
+	uring->sq_array[ tail & mask ] = tail & mask;
+	pgm_uring_store_release (uring->sq_tail, tail + 1);
+	uring->to_submit++;
+	return TRUE;
+}
+
+/* submit all queued requests with one system call without waiting for
+ * completions.
+ *
+ * returns 0 on success, returns -1 on error and sets errno.
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_uring_submit (
+	pgm_uring_t*	uring
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != uring);
+
+	while (uring->to_submit > 0) {
+		const int n = (int)syscall (__NR_io_uring_enter, uring->fd, uring->to_submit, 0, 0, NULL, 0);
+		if (n < 0) {
+			if (EINTR == errno)
+				continue;
+			return -1;
+		}
+#ifdef URING_DEBUG
+		pgm_debug ("io_uring_enter submitted %d of %u", n, uring->to_submit);
+#endif
+		if (0 == n) {
+			errno = EAGAIN;
+			return -1;
+		}
+		uring->to_submit -= (unsigned)n;
+	}
+	return 0;
+}
+
+/* take the next completion from the completion queue.
+ *
+ * returns TRUE and the slot index and result on completion, returns FALSE
+ * when the queue is empty.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_uring_reap (
+	pgm_uring_t* restrict uring,
+	unsigned*    restrict index,
+	int*	     restrict res
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != uring);
+	pgm_assert (NULL != index);
+	pgm_assert (NULL != res);
+
+	const unsigned head = *uring->cq_head;
+	if (head == pgm_uring_load_acquire (uring->cq_tail))
+		return FALSE;
+	const struct io_uring_cqe* cqe = &uring->cqes[ head & *uring->cq_mask ];
+	*index	= (unsigned)cqe->user_data;
+	*res	= cqe->res;
+	pgm_uring_store_release (uring->cq_head, head + 1);
+	return TRUE;
+}
+
+#endif /* HAVE_LINUX_IO_URING_H */
+
+/* eof */